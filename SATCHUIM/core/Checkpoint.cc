@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "core/Cooperation.h"
+#include "core/Checkpoint.h"
+#include "core/Incremental.h"
+#include "core/Output.h"
+
+using namespace Minisat;
+
+static const char journalMagic[] = "SATCHUIM-CHECKPOINT";
+static const int  journalVersion = 1;
+
+
+// FNV-1a over the database, the settings and the guiding paths: paths are only known by their index
+uint64_t Checkpoint::runKey(Cooperation& coop)
+{
+    uint64_t h = Increment::hashTransactions(coop, coop.list_transactions.size());
+    h = (h ^ (uint32_t)coop.min_supp)  * 1099511628211ull;
+    h = (h ^ (uint32_t)coop.enum_clos) * 1099511628211ull;
+    for (int i = 0; i < coop.itemName.size(); i++)
+        h = (h ^ (uint32_t)coop.itemName[i]) * 1099511628211ull;
+    for (int k = 0; k < coop.VecGuiding.size(); k++){
+        for (int j = 0; j < coop.VecGuiding[k].size(); j++)
+            h = (h ^ (uint32_t)toInt(coop.VecGuiding[k][j])) * 1099511628211ull;
+        h = (h ^ 0xffffffffu) * 1099511628211ull;
+    }
+    return h;
+}
+
+
+bool Checkpoint::load(const char* name, Cooperation& coop)
+{
+    FILE* f = fopen(name, "r");
+    if (f == NULL) return false;
+    char               tag[32];
+    int                version, n;
+    unsigned long long key;
+    bool ok = fscanf(f, "%31s %d %llu %d", tag, &version, &key, &n) == 4 && strcmp(tag, journalMagic) == 0
+           && version == journalVersion && key == runKey(coop) && n == coop.VecGuiding.size() && fgetc(f) == '\n';
+
+    // a line cut by the interruption ends the journal
+    done.clear();
+    done.growTo(coop.VecGuiding.size(), 0);
+    paths    = 0;
+    patterns = 0;
+    length   = ok ? ftell(f) : 0;
+    int                path;
+    unsigned long long cnt;
+    while (ok && fscanf(f, "%d %llu", &path, &cnt) == 2 && fgetc(f) == '\n' && path >= 0 && path < done.size()){
+        if (!done[path])
+            done[path] = 1, paths++, patterns += cnt;
+        length = ftell(f);
+    }
+    fclose(f);
+    return ok;
+}
+
+
+bool Checkpoint::open(const char* name, Cooperation& coop)
+{
+    if (paths > 0){
+        if (truncate(name, length) != 0) return false;
+        file = fopen(name, "a");
+        return file != NULL;
+    }
+    file = fopen(name, "w");
+    if (file == NULL) return false;
+    fprintf(file, "%s %d %llu %d\n", journalMagic, journalVersion, (unsigned long long)runKey(coop), coop.VecGuiding.size());
+    return fflush(file) == 0;
+}
+
+
+void Checkpoint::record(int path, uint64_t n)
+{
+#pragma omp critical(checkpoint)
+    {
+        fprintf(file, "%d %llu\n", path, (unsigned long long)n);
+        fflush(file);
+    }
+}
+
+
+// The itemsets of the previous results whose guiding path is finished: the path of the item of the
+// itemset first in 'allItems' (the earlier ones are false on it) whose second literals it satisfies.
+int Checkpoint::keep(const char* previous, ItemsetWriter* out, Cooperation& coop) const
+{
+    ItemsetReader in;
+    if (!in.open(previous)) return -1;
+
+    vec<vec<int> >  pathsOf(coop.nbItems);
+    vec<int>        pos(coop.nbItems), byName;
+    const vec<Lit>& order = coop.solvers[0].allItems;
+    for (int k = 0; k < coop.VecGuiding.size(); k++)
+        pathsOf[var(coop.VecGuiding[k][0])].push(k);
+    for (int i = 0; i < order.size(); i++)
+        pos[var(order[i])] = i;
+    for (Var v = 0; v < coop.itemName.size(); v++){
+        if (coop.itemName[v] >= byName.size()) byName.growTo(coop.itemName[v] + 1, -1);
+        byName[coop.itemName[v]] = v;
+        CsrRow<Var> also = coop.itemAlso[v];       // (merged items: those of 'v')
+        for (int j = 0; j < also.size(); j++){
+            if (also[j] >= byName.size()) byName.growTo(also[j] + 1, -1);
+            byName[also[j]] = v; } }
+
+    vec<int>  items;
+    vec<Var>  vars;
+    vec<char> mark(coop.nbItems, 0);
+    int       util, sup, n = 0;
+    while (in.next(items, util, sup)){
+        vars.clear();
+        for (int i = 0; i < items.size() && items[i] >= 0 && items[i] < byName.size() && byName[items[i]] >= 0; i++)
+            vars.push(byName[items[i]]);
+        if (vars.size() == 0 || vars.size() < items.size()) continue;
+
+        Var p = vars[0];
+        for (int i = 0; i < vars.size(); i++){
+            mark[vars[i]] = 1;
+            if (pos[vars[i]] < pos[p]) p = vars[i]; }
+        int path = -1;
+        for (int j = 0; j < pathsOf[p].size() && path < 0; j++){
+            const vec<Lit>& g = coop.VecGuiding[pathsOf[p][j]];
+            bool fits = true;
+            for (int l = 1; l < g.size() && fits; l++)
+                fits = mark[var(g[l])] != sign(g[l]);
+            if (fits) path = pathsOf[p][j];
+        }
+        for (int i = 0; i < vars.size(); i++)
+            mark[vars[i]] = 0;
+
+        if (path >= 0 && finished(path)){
+            if (out != NULL) out->writeNow(items, util, sup);
+            n++; }
+    }
+    return n;
+}
+
+
+void Checkpoint::close()
+{
+    if (file != NULL) fclose(file);
+    file = NULL;
+}
@@ -0,0 +1,52 @@
+#ifndef Minisat_Checkpoint_h
+#define Minisat_Checkpoint_h
+
+#include <stdio.h>
+
+#include "mtl/IntTypes.h"
+#include "mtl/Vec.h"
+
+namespace Minisat {
+
+class Cooperation;
+class ItemsetWriter;
+
+/*=================================================================================================
+ Checkpoint Class : ->  [class]
+Description:
+	Journal of the guiding paths finished by a run ('-checkpoint'), so that an interrupted run can
+	be taken up again ('-resume') without mining them twice. Each path is appended to it with its
+	number of itemsets once these are all in the result file (see 'ItemsetWriter::pathDone()').
+	The journal starts with a key of the run (database, minutil, closedness and guiding paths): it
+	only applies to a run of the same key. An itemset belongs to only one guiding path, told by its
+	items, so on resuming the itemsets of the finished paths are kept from the result file and
+	those of the paths left unfinished are dropped, to be mined again.
+=================================================================================================*/
+
+  class Checkpoint {
+
+    FILE*          file;                    // journal, appended to
+    long           length;                  // complete part of the journal read by 'load()'
+    vec<char>      done;                    // paths finished by the previous runs ...
+
+  public:
+    int            paths;                   // ... how many ...
+    uint64_t       patterns;                // ... and their itemsets
+
+    Checkpoint() : file(NULL), length(0), paths(0), patterns(0) { }
+   ~Checkpoint()                            { close(); }
+
+    bool           load     (const char* name, Cooperation& coop);          // false: not a journal of this run
+    bool           open     (const char* name, Cooperation& coop);          // goes on with the loaded journal, or starts one
+    bool           finished (int path) const { return path < done.size() && done[path]; }
+    void           record   (int path, uint64_t n);                         // path finished (thread safe)
+    int            keep     (const char* previous, ItemsetWriter* out, Cooperation& coop) const;  // -1: can't read
+    void           close    ();
+
+    static uint64_t runKey  (Cooperation& coop);
+  };
+
+//=================================================================================================
+}
+
+#endif
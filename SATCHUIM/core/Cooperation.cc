@@ -16,52 +16,45 @@ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FO
 DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
 OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 *******************************************************************************************/
+#include <omp.h>
+#include <string.h>
+
+#include "core/Checkpoint.h"
 #include "core/Cooperation.h"
+#include "core/Distributed.h"
 #include "mtl/Sort.h"
+#include "utils/System.h"
 
 namespace Minisat {
 
 
   /*_________________________________________________________________________________________________
     |
-    |  addTableClause_ : ()  ->  [bool]
-    |  Description : manage assumptions in a VecGuiding
+    |  addTransaction_ : (items, tu, util)  ->  [bool]
+    |  Description : append a transaction of the database: its items, their utilities and its utility.
     |________________________________________________________________________________________________@*/
 
-
-bool Cooperation::addTableClause_(vec<Lit>& ps)
-{
-    // Check if clause is satisfied and remove false/duplicate literals:
-  list_transactions.push();
-  int ind = list_transactions.size()-1;
-  int i = 0;
-  while (i < ps.size() && !sign(ps[i])) {
-    list_transactions[ind].push(ps[i]);
-    i++;
-  }
-                                                          
-  wItemTrans.push();
-  wTrans.push(var(ps[i+1])+1); 
-  i+= 3;
-  while(i < ps.size()){
-    wItemTrans[ind].push(var(ps[i])+1);
-    i++;
+  bool Cooperation::addTransaction_(vec<Lit>& items, int tu, vec<int>& util)
+  {
+    list_transactions.push();
+    wItemTrans.push();
+    for (int i = 0; i < items.size(); i++){
+      list_transactions.push(items[i]);
+      wItemTrans.push(util[i]);
+    }
+    wTrans.push(tu);
+    return true;
   }
-
-  return true;
-}
   
   bool Cooperation::addWeightedItems_(vec<int>& ps)
   {
     wItemTrans.push();
-    wTrans.push();
     int cpt = 0;
-    int ind = wItemTrans.size()-1;
     for (int i = 0; i < ps.size(); i++){
-      wItemTrans[ind].push(ps[i]);
+      wItemTrans.push(ps[i]);
       cpt += ps[i];
     }
-    wTrans[ind] = cpt; 
+    wTrans.push(cpt); 
     return true;
   }
 
@@ -91,6 +84,22 @@ bool Cooperation::addTableClause_(vec<Lit>& ps)
   
 
 
+  struct coocc_gt {
+    vec<int>&  co;
+    coocc_gt(vec<int>& co_) : co(co_) {}
+    bool operator () (Var x, Var y) {
+      return co[x] > co[y]; }
+  };
+
+
+  struct cost_gt {
+    vec<double>&  cost;
+    cost_gt(vec<double>& cost_) : cost(cost_) {}
+    bool operator () (int x, int y) {
+      return cost[x] > cost[y]; }
+  };
+
+
   void Cooperation::permute(vec<Lit>& vec1, vec<Lit>& vec2){
   
     vec<Lit> tmp;
@@ -129,46 +138,288 @@ bool Cooperation::addTableClause_(vec<Lit>& ps)
     |  Decomposition phase
     |________________________________________________________________________________________________@*/
 
-  void Cooperation::buildGuidingPaths(){
+  struct occ_lt {
+    vec<int>&  occ;
+    occ_lt(vec<int>& occ_) : occ(occ_) {}
+    bool operator () (Var x, Var y) {
+      return occ[x] < occ[y] || (occ[x] == occ[y] && x < y); }
+  };
 
-    vec<Lit> items;
 
-    for(int i = 0; i < solvers[0].nVars(); i++){
-      items.push(mkLit(i, false));
-      correl.push();
-    }
-    
-    for(int  i = 0; i < items.size(); i++){
-      appearTrans.push();
-      occ.push(0);
-      wocc.push(0);
-    }
+  /*_________________________________________________________________________________________________
+    |
+    |  copyDatabase : (Cooperation& from)  ->  [void]
+    |  Description : take a copy of the database loaded (and counted) by another cooperation, so that
+    |  it can be mined again: pruneItems() rewrites the tables it works on.
+    |________________________________________________________________________________________________@*/
+
+  void Cooperation::copyDatabase(Cooperation& from){
+    nbItems = from.nbItems;
+    from.list_transactions.copyTo(list_transactions);
+    from.wItemTrans       .copyTo(wItemTrans);
+    from.wTrans           .copyTo(wTrans);
+    from.appearTrans      .copyTo(appearTrans);
+    from.occ              .copyTo(occ);
+    from.wocc             .copyTo(wocc);
+    from.itemOrder        .copyTo(itemOrder);
+  }
+
+
+  /*_________________________________________________________________________________________________
+    |
+    |  countItems : ()  ->  [void]
+    |  Description : support (occ), TWU (wocc) and transactions (appearTrans) of each item, and the
+    |  items by increasing support. None of it depends on minutil, so the database cache stores it.
+    |________________________________________________________________________________________________@*/
+
+  void Cooperation::countItems(){
 
+    appearTrans.shape(nbItems);
+    occ .clear();
+    wocc.clear();
+    occ .growTo(nbItems, 0);
+    wocc.growTo(nbItems, 0);
     
     for( int i = 0; i < list_transactions.size(); i++){
-      for(int j = 0;j< list_transactions[i].size(); j++){
-	Var v = var(list_transactions[i][j]);
+      CsrRow<Lit> trans = list_transactions[i];
+      for(int j = 0;j< trans.size(); j++){
+	Var v = var(trans[j]);
 	occ [v] ++;
 	wocc[v] += wTrans[i];
-	appearTrans[v].push(i);
+	appearTrans.grow(v);
       }
     }
+    appearTrans.alloc();
+    for( int i = 0; i < list_transactions.size(); i++){
+      CsrRow<Lit> trans = list_transactions[i];
+      for(int j = 0;j< trans.size(); j++)
+	appearTrans.fill(var(trans[j]), i);
+    }
+
+    itemOrder.clear();
+    for(int i = 0; i < nbItems; i++)
+      itemOrder.push(i);
+    sort(itemOrder, occ_lt(occ));
+  }
+
+
+  /*_________________________________________________________________________________________________
+    |
+    |  pruneItems : ()  ->  [void]
+    |  Description : remove from the transactions the items whose TWU is below minutil, which lowers
+    |  the utility of their transactions and so the TWU of the other items, until no item drops out.
+    |  No high utility itemset, nor any item that could make one non closed, is removed. The items
+    |  left are renumbered by increasing support and the emptied transactions dropped; itemName maps
+    |  them back to the items of the input. In closed mode, the items in the same transactions are in
+    |  the same closed itemsets: each is merged into the first of them, with its utilities, and is
+    |  listed in itemAlso for the output.
+    |________________________________________________________________________________________________@*/
 
-    for(int  i = 0; i < items.size(); i++)
-      if(wocc[var(items[i])] < min_supp){
-	occ[var(items[i])] = 0;
+  void Cooperation::pruneItems(){
+
+    vec<char> keep(nbItems, 1);
+    for(bool changed = true; changed; ){
+      changed = false;
+      for(int v = 0; v < nbItems; v++)
+	if(keep[v] && wocc[v] < min_supp){
+	  keep[v] = 0;
+	  changed = true;
+	}
+      if(!changed)
+	break;
+
+      for(int v = 0; v < nbItems; v++)
+	wocc[v] = 0;
+      for(int i = 0; i < list_transactions.size(); i++){
+	CsrRow<Lit> trans = list_transactions[i];
+	CsrRow<int> util  = wItemTrans[i];
+	wTrans[i] = 0;
+	for(int j = 0; j < trans.size(); j++)
+	  if(keep[var(trans[j])])
+	    wTrans[i] += util[j];
+	for(int j = 0; j < trans.size(); j++)
+	  if(keep[var(trans[j])])
+	    wocc[var(trans[j])] += wTrans[i];
       }
-    
-    for(int  i = 0; i < items.size()-1; i++)
-      for(int  j = i+1; j < items.size(); j++)
-	if(occ[var(items[j])] < occ[var(items[i])]){
-	  Lit p = items[i];
-	  items[i] = items[j];
-	  items[j] = p;
- 	}
-
-    for(int t = 0; t < nbThreads; t++)
+    }
+
+    // equivalent items: same support and hash of their transactions first, then compared
+    vec<Var> into(nbItems, var_Undef);
+    if(enum_clos == 1){
+      vec<uint32_t> hash(nbItems);
+      vec<Var>      cand;
+      for(int v = 0; v < nbItems; v++)
+	if(keep[v]){
+	  CsrRow<int> col = appearTrans[v];
+	  uint32_t    h   = 2166136261u;
+	  for(int j = 0; j < col.size(); j++)
+	    h = (h ^ col[j]) * 16777619u;
+	  hash[v] = h;
+	  cand.push(v);
+	}
+      ItemKey_lt lt(occ, hash);
+      sort(cand, lt);
+      for(int i = 0, r = 0; i < cand.size(); i++){
+	Var v = cand[i], q = cand[r];
+	if(i > r && lt.same(q, v) && memcmp((int*)appearTrans[v], (int*)appearTrans[q], occ[v] * sizeof(int)) == 0){
+	  into[v] = q;
+	  keep[v] = 0;
+	}else
+	  r = i;
+      }
+    }
+
+    vec<Var> rank(nbItems, var_Undef);
+    itemName.clear();
+    for(int i = 0; i < itemOrder.size(); i++)
+      if(keep[itemOrder[i]]){
+	rank[itemOrder[i]] = itemName.size();
+	itemName.push(itemOrder[i]);
+      }
+    itemAlso.shape(itemName.size());
+    for(int v = 0; v < nbItems; v++)
+      if(into[v] != var_Undef)
+	itemAlso.grow(rank[into[v]]);
+    itemAlso.alloc();
+    for(int i = 0; i < itemOrder.size(); i++)
+      if(into[itemOrder[i]] != var_Undef)
+	itemAlso.fill(rank[into[itemOrder[i]]], itemOrder[i]);
+
+    // the items of each transaction are sorted, so that equal transactions have equal rows
+    Csr<Lit> prunedItems;
+    Csr<int> prunedUtil;
+    vec<int> prunedTU;
+    vec<Lit> lits;
+    vec<int> u(nbItems);
+    int      first = 0;
+    for(int i = 0; i < list_transactions.size(); i++){
+      CsrRow<Lit> trans = list_transactions[i];
+      CsrRow<int> util  = wItemTrans[i];
+      lits.clear();
+      for(int j = 0; j < trans.size(); j++)
+	if(keep[var(trans[j])]){
+	  lits.push(mkLit(rank[var(trans[j])], false));
+	  u[rank[var(trans[j])]] = util[j];
+	}
+      for(int j = 0; j < trans.size(); j++)
+	if(into[var(trans[j])] != var_Undef)
+	  u[rank[into[var(trans[j])]]] += util[j];
+      if(lits.size() == 0)
+	continue;
+      sort(lits);
+      prunedItems.push();
+      prunedUtil .push();
+      for(int j = 0; j < lits.size(); j++){
+	prunedItems.push(lits[j]);
+	prunedUtil .push(u[var(lits[j])]);
+      }
+      prunedTU.push(wTrans[i]);
+      if(i < firstNew)
+	first++;
+    }
+    firstNew = first;
+    prunedItems.moveTo(list_transactions);
+    prunedUtil .moveTo(wItemTrans);
+    prunedTU   .moveTo(wTrans);
+
+    nbItems = itemName.size();
+    countItems();
+  }
+
+
+  /*_________________________________________________________________________________________________
+    |
+    |  addTopItemset : (set : vec<Var>&) (util : int) (sup : int)  ->  [void]
+    |  Description : top-k mode, record an itemset found by a thread. Once k itemsets are kept, minutil
+    |  is raised above the least of them, so that every thread prunes with the best threshold seen.
+    |________________________________________________________________________________________________@*/
+
+  void Cooperation::addTopItemset(vec<Var>& set, int util, int sup){
+#pragma omp critical(topk)
+    {
+      // another thread may have raised minutil since this itemset was found
+      if(util >= min_supp){
+	int slot;
+	if(topHeap.size() < topk){
+	  slot = topSets.size();
+	  topSets.push();
+	  topUtil.push(util);
+	  topSup .push(sup);
+	}else{
+	  slot = topHeap.removeMin();
+	  topUtil[slot] = util;
+	  topSup [slot] = sup;
+	}
+	set.copyTo(topSets[slot]);
+	topHeap.insert(slot);
+	if(topHeap.size() == topk){
+	  int m = topUtil[topHeap[0]] + 1;
+#pragma omp atomic write
+	  min_supp = m;
+	}
+      }
+    }
+  }
+
+
+  struct topUtil_gt {
+    vec<int>&  util;
+    topUtil_gt(vec<int>& util_) : util(util_) {}
+    bool operator () (int x, int y) {
+      return util[x] > util[y] || (util[x] == util[y] && x < y); }
+  };
+
+
+  // Writes the top-k itemsets by decreasing utility, once the threads are done.
+  void Cooperation::writeTopItemsets(){
+    vec<int> order;
+    for(int i = 0; i < topSets.size(); i++)
+      order.push(i);
+    sort(order, topUtil_gt(topUtil));
+    for(int i = 0; i < order.size(); i++)
+      out->write(0, topSets[order[i]], topUtil[order[i]], topSup[order[i]]);
+  }
+
+
+  // Creates the item variables of every thread's solver at once, each on the thread that mines with
+  // it: with 'pin', that thread is bound to its CPU first, so that the solver is first touched on its
+  // node (see 'placeThreads()'). A short team (OMP_DYNAMIC) takes the solvers of the missing threads too.
+  void Cooperation::allocItems(){
+#pragma omp parallel num_threads(nbThreads)
+    for (int t = omp_get_thread_num(); t < nbThreads; t += omp_get_num_threads()){
+      if (pin) pinThread(t);
+      while (solvers[t].nVars() < nbItems)
+	solvers[t].newVar();
+    }
+  }
+
+
+  void Cooperation::buildGuidingPaths(){
+
+    vec<Lit> items;
+
+    if(itemOrder.size() != nbItems)
+      countItems();
+    pruneItems();
+    allocItems();
+
+    for(int i = 0; i < nbItems; i++)
+      correl.push();
+
+    // items below minutil first, then by increasing support
+    for(int  i = 0; i < itemOrder.size(); i++)
+      if(wocc[itemOrder[i]] < min_supp){
+	occ[itemOrder[i]] = 0;
+	items.push(mkLit(itemOrder[i], false));
+      }
+    for(int  i = 0; i < itemOrder.size(); i++)
+      if(wocc[itemOrder[i]] >= min_supp)
+	items.push(mkLit(itemOrder[i], false));
+
+    for(int t = 0; t < nbThreads; t++){
       items.copyTo(solvers[t].allItems);
+      itemName.copyTo(solvers[t].itemName);
+    }
     
 
     int nb = 0;
@@ -177,13 +428,76 @@ bool Cooperation::addTableClause_(vec<Lit>& ps)
 	nb++;
 
     div_begining = 0;
+    nextPath     = 0;
+
+    // cost model: schedule the most expensive guiding paths first and split the paths heavier
+    // than half the fair share of a thread over their most frequent second items
+    vec<int>    pos(items.size());
+    vec<int>    co (items.size(), 0);
+    vec<Var>    cand;
+    vec<double> cost;
+    double      total = 0;
+
+    for(int i = 0; i < items.size(); i++)
+      pos[var(items[i])] = i;
+
+    for(int k = 0; k < items.size(); k++){
+      cost.push(pathCost(k, items, pos, co, cand));
+      total += cost[k];
+      for(int j = 0; j < cand.size(); j++)
+	co[cand[j]] = 0;
+    }
+
+    vec<vec<Lit> > paths;
+    vec<int>       index;
+    vec<double>    pcost;
+
+    for(int k = 0; k < items.size(); k++){
+      if(wocc[var(items[k])] < min_supp)
+	continue;
 
-   printf("---------------------------------------------------------------------------------------------------\n");
-    printf("  DataBase Description          |-- #items    : %10d       \n",items.size());
-    printf("                                |-- #transactions    : %10d      \n", list_transactions.size());
-    // printf(" +++++++++++++++++++++++++     +-|-+                                       | \n");
-    //printf("                                 |                                         | \n");
-    printf("---------------------------------------------------------------------------------------------------\n");
+      if(splitWidth < 1 || nbThreads < 2 || cost[k] <= total / (2 * nbThreads)){
+	paths.push();
+	paths.last().push(items[k]);
+	index.push(k+1);
+	pcost.push(cost[k]);
+	continue;
+      }
+
+      // heavy path: sub-paths [p, ~c1, .., ~cj-1, cj] and the remainder [p, ~c1, .., ~cs]
+      pathCost(k, items, pos, co, cand);
+      sort(cand, coocc_gt(co));
+      int    s = cand.size() < splitWidth ? cand.size() : splitWidth;
+      double w = (double)wocc[var(items[k])] / min_supp;
+      for(int j = 0; j <= s; j++){
+	paths.push();
+	paths.last().push(items[k]);
+	for(int l = 0; l < j && l < s; l++)
+	  paths.last().push(mkLit(cand[l], true));
+	if(j < s)
+	  paths.last().push(mkLit(cand[j], false));
+	index.push(k+1);
+	pcost.push((j < s ? co[cand[j]] : appearTrans.size(var(items[k]))) * (double)(cand.size() - j) * w);
+      }
+      for(int j = 0; j < cand.size(); j++)
+	co[cand[j]] = 0;
+    }
+
+    vec<int> order;
+    for(int i = 0; i < paths.size(); i++)
+      order.push(i);
+    sort(order, cost_gt(pcost));
+    for(int i = 0; i < order.size(); i++)
+      addGuidingPath(paths[order[i]], index[order[i]], pcost[order[i]]);
+
+    if(solvers[0].verbosity > 0){
+      printf("---------------------------------------------------------------------------------------------------\n");
+      printf("  DataBase Description          |-- #items    : %10d       \n",items.size());
+      printf("                                |-- #transactions    : %10d      \n", list_transactions.size());
+      // printf(" +++++++++++++++++++++++++     +-|-+                                       | \n");
+      //printf("                                 |                                         | \n");
+      printf("---------------------------------------------------------------------------------------------------\n");
+    }
     
 
     //copy the sorted items to each threads
@@ -200,411 +514,179 @@ bool Cooperation::addTableClause_(vec<Lit>& ps)
   
   /*_________________________________________________________________________________________________
     |
-    |  exportExtraUnit : ()  ->  [void]
-    |  Description : manage export Extra Unit Clauses 
+    |  pathCost : ()  ->  [double]
+    |  Description : estimate the cost of the guiding path of the k-th item from its projected
+    |  database: #transactions x #candidate items, scaled by how far its TWU (wocc) is above minutil.
+    |  The candidate items (later in the order, TWU >= minutil) are left in cand, their number of
+    |  co-occurrences with the item in co.
     |________________________________________________________________________________________________@*/
-  
-  void Cooperation::exportExtraUnit(Solver* s, Lit unit){
-    
-    int id = s->threadId;
-    
-    for(int t = 0; t < nbThreads; t++){
-      
-      if(t == id) continue;
-      int ind = tailExtraUnits[id][t];
-      if(((ind+1)%MAX_EXTRA_UNITS) == headExtraUnits[id][t]) continue;
-      
-      extraUnits[id][t][ind++].x = unit.x;
-      
-      if(ind == MAX_EXTRA_UNITS) ind = 0;
-      tailExtraUnits[id][t] = ind;
-    }
-  }
 
-  /*_________________________________________________________________________________________________
-    |
-    |  importExtraUnits : ()  ->  [void]
-    |  Description : store unit extra clause in the vector unit_learnts
-    |________________________________________________________________________________________________@*/
-  
-  void Cooperation::importExtraUnits(Solver* s, vec<Lit>& unit_learnts){ 
-    
-    int id = s->threadId;
-    
-    for(int t = 0; t < nbThreads; t++){
-      
-      if(t == id) 
-	continue;
-      
-      int head = headExtraUnits[t][id];
-      int tail = tailExtraUnits[t][id];
-      if(head == tail) 
-	continue;
-      
-      int end = tail; 
-      if(tail < head) end = MAX_EXTRA_UNITS;
-      
-      for(int i = head; i < end; i++)
-	storeExtraUnits(s, t, extraUnits[t][id][i], unit_learnts);
-      
-      if(tail < head)
-	for(int i = 0; i < tail; i++)
-	  storeExtraUnits(s, t, extraUnits[t][id][i], unit_learnts);
-      
-      head = tail;
-      if(head == MAX_EXTRA_UNITS) head = 0;
-      headExtraUnits[t][id] = head;
+  double Cooperation::pathCost(int k, vec<Lit>& items, vec<int>& pos, vec<int>& co, vec<Var>& cand){
+
+    Var p = var(items[k]);
+    cand.clear();
+    if(wocc[p] < min_supp)
+      return 0;
+
+    for(int i = 0; i < appearTrans.size(p); i++){
+      CsrRow<Lit> trans = list_transactions[appearTrans[p][i]];
+      for(int j = 0; j < trans.size(); j++){
+	Var v = var(trans[j]);
+	if(pos[v] > k && wocc[v] >= min_supp && co[v]++ == 0)
+	  cand.push(v);
+      }
     }
+
+    double w = (double)wocc[p] / min_supp;
+    return appearTrans.size(p) * (double)(cand.size() + 1) * w;
   }
-    
+
+
   /*_________________________________________________________________________________________________
     |
-    |  importExtraUnits : ()  ->  [void]
-    |  Description : manage import Extra Unit Clauses 
+    |  addGuidingPath : ()  ->  [void]
+    |  Description : append a guiding path: the literals fixed at level 0 (item first) with the
+    |  position of the item in allItems and its estimated cost
     |________________________________________________________________________________________________@*/
-  
-  void Cooperation::importExtraUnits(Solver* s){ 
-    
-    int id = s->threadId;
-    
-    for(int t = 0; t < nbThreads; t++){
-      
-      if(t == id) 
-	continue;
-      
-      int head = headExtraUnits[t][id];
-      int tail = tailExtraUnits[t][id];
-      if(head == tail) 
-	continue;
-      
-      int end = tail; 
-      if(tail < head) end = MAX_EXTRA_UNITS;
-      
-      for(int i = head; i < end; i++)
-	uncheckedEnqueue(s, t, extraUnits[t][id][i]);
-      
-      if(tail < head)
-	for(int i = 0; i < tail; i++)
-	  uncheckedEnqueue(s, t, extraUnits[t][id][i]);
-      
-      head = tail;
-      if(head == MAX_EXTRA_UNITS) head = 0;
-      headExtraUnits[t][id] = head;
-    }
+
+  void Cooperation::addGuidingPath(vec<Lit>& path, int index, double cost){
+    VecGuiding.push();
+    path.copyTo(VecGuiding.last());
+    guidingIndex.push(index);
+    guidingCost.push(cost);
   }
-  
-  
+
+
   /*_________________________________________________________________________________________________
     |
-    |  uncheckedEnqueue : ()  ->  [void]
-    |  Description: Enqueue the unit literals at level 0
+    |  nextGuidingPath : ()  ->  [int]
+    |  Description : hand out the next guiding path (index in VecGuiding) to the calling thread.
+    |  Paths are taken dynamically, so a thread that finishes early picks up the next unmined one
+    |  instead of waiting on a statically assigned one. A value >= VecGuiding.size() means no work left.
+    |  The paths finished by an interrupted run are skipped, see 'Checkpoint'.
     |________________________________________________________________________________________________@*/
-  
-  void Cooperation::uncheckedEnqueue(Solver* s, int t, Lit l){
-    
-    if(s->value(l) == l_False) answers[s->threadId] = l_False;
-    
-    if(s->value(l) != l_Undef) return;
-    s->uncheckedEnqueue(l);
-    nbImportedExtraUnits[s->threadId]++;
-    pairwiseImportedExtraClauses[t][s->threadId]++;
+
+  int Cooperation::nextGuidingPath(){
+    int k;
+    do{
+#ifdef USE_MPI
+      k = distNextPath();
+#else
+#pragma omp atomic capture
+      k = nextPath++;
+#endif
+    }while(checkpoint != NULL && checkpoint->finished(k));
+    return k;
   }
 
+
   /*_________________________________________________________________________________________________
     |
-    |  uncheckedEnqueue : ()  ->  [void]
-    |  Description: Enqueue the unit literals at level 0
+    |  pathDone : (s : Solver*) (path : int) (n : uint64_t)  ->  [void]
+    |  Description : the thread of 's' has mined all of the guiding path 'path', 'n' itemsets. It is
+    |  recorded in the checkpoint, after these itemsets when they are written out.
     |________________________________________________________________________________________________@*/
-  
-  void Cooperation::storeExtraUnits(Solver* s, int t, Lit l, vec<Lit>& unitLits){
-    unitLits.push(l);
-    nbImportedExtraUnits[s->threadId]++;
-    pairwiseImportedExtraClauses[t][s->threadId]++;
+
+  void Cooperation::pathDone(Solver* s, int path, uint64_t n){
+    if (checkpoint == NULL) return;
+    if (out != NULL) out->pathDone(s->threadId, path, n);
+    else             checkpoint->record(path, n);
   }
-  
-  /*_________________________________________________________________________________________________
-    |
-    |  exportExtraClause : ()  ->  [void]
-    |  Description: each time a new clause is learnt, it is exported to other threads
-    |________________________________________________________________________________________________@*/
-  
-  
-  void Cooperation::exportExtraClause(Solver* s, vec<Lit>& learnt){
-    
-    int id = s->threadId;
-    
-    for(int t = 0; t < nbThreads; t++){
-      
-      if((t == id) || (learnt.size() > pairwiseLimitExportClauses[id][t])) 
-	continue;
-      
-      int ind = tailExtraClauses[id][t];
-      if(((ind+1) % MAX_EXTRA_CLAUSES) == headExtraClauses[id][t]) 
-	continue;
-      
-      extraClauses[id][t][ind]    = new Lit [learnt.size() + 1];
-      extraClauses[id][t][ind][0] = mkLit(learnt.size(), false);
-      
-      for(int j = 0; j < learnt.size(); j++)
-	extraClauses[id][t][ind][j + 1] = learnt[j];
-      
-      ind++;
-      if(ind == MAX_EXTRA_CLAUSES) ind = 0;
-      tailExtraClauses[id][t] = ind;
-    }
-  }		      
-  
-  
+
+
   /*_________________________________________________________________________________________________
     |
-    |  exportExtraClause : ()  ->  [void]
-    |  Description: each time a new clause is learnt, it is exported to other threads
+    |  placeThreads : ()  ->  [void]
+    |  Description : point each thread at the database it reads. With 'numa' and threads on several
+    |  NUMA nodes, the first thread of each node copies the database, its pages being then local to
+    |  the node (first touch), and the threads of the node read that copy rather than the one of the
+    |  node that parsed it. Thread t runs on the t-th CPU, see 'pinThread()'.
     |________________________________________________________________________________________________@*/
-  
-  void Cooperation::exportExtraClause(Solver* s, Clause& c){
-    
-    int id = s->threadId;
-    
+
+  void Cooperation::placeThreads(){
+    for(int i = 0; i < replicas.size(); i++)
+      delete replicas[i];
+    replicas.clear();
     for(int t = 0; t < nbThreads; t++){
-      
-      if((t == id) || (c.size() > pairwiseLimitExportClauses[id][t])) 
-	continue;
-      
-      int ind = tailExtraClauses[id][t];
-      if(((ind+1) % MAX_EXTRA_CLAUSES) == headExtraClauses[id][t]) 
-	continue;
-      
-      extraClauses[id][t][ind]    = new Lit [c.size() + 1];
-      extraClauses[id][t][ind][0] = mkLit(c.size(), false);
-      
-      for(int j = 0; j < c.size(); j++)
-	extraClauses[id][t][ind][j + 1] = c[j];
-      
-      ind++;
-      if(ind == MAX_EXTRA_CLAUSES) ind = 0;
-      tailExtraClauses[id][t] = ind;
+      solvers[t].dbTrans  = &list_transactions;
+      solvers[t].dbUtil   = &wItemTrans;
+      solvers[t].dbAppear = &appearTrans;
     }
-  }		      
-  
-  /*_________________________________________________________________________________________________
-    |
-    |  importExtraClauses : ()  ->  [void]
-    |  Description: import Extra clauses sent from other threads
-    |_______________________________________________________________________________________________@*/
-  
-  void Cooperation::importExtraClauses(Solver* s){
-    
-    int id = s->threadId;
-    
-    for(int t = 0; t < nbThreads; t++){
-      
-      if(t == id) 
-	continue;
-      
-      int head = headExtraClauses[t][id];
-      int tail = tailExtraClauses[t][id];
-      if(head == tail) 
-	continue;
-      
-      int end = tail; 
-      if(tail < head) end = MAX_EXTRA_CLAUSES;
-      
-      for(int i = head; i < end; i++)
-	addExtraClause(s, t, extraClauses[t][id][i]);
-      
-      if(tail < head)
-	for(int i = 0; i < tail; i++)
-	  addExtraClause(s, t, extraClauses[t][id][i]);
-      
-      head = tail;
-      if(head == MAX_EXTRA_CLAUSES) head = 0;
-      headExtraClauses[t][id] = head;
-    }
-  }    
 
-	
-  /*_________________________________________________________________________________________________
-    |
-    |  addExtraClause : ()  ->  [void]
-    |  Description: build a clause from the learnt Extra Lit*
-    |  watch it correctly, test basic cases distinguich other cases during watching process 
-    |________________________________________________________________________________________________@*/
-  
-  
-  void Cooperation::addExtraClause(Solver* s, int t, Lit* lt){
-    
-    vec<Lit>  extra_clause;           
-    int       extra_backtrack_level = 0;
-    int id   = s->threadId;
-    int size = var(lt[0]);
-    int    wtch = 0;
-    Lit q = lit_Undef;
-    
-    for(int i = 1, j = 0; i < size+1; i++) {
-      Lit q = lt[i];
-      if(s->value(q) == l_False && s->level(var(q)) == 0)
-	continue;
-      extra_clause.push(q);
-      if(s->value(q) != l_False && wtch < 2){
-	extra_clause[j] = extra_clause[wtch];
-	extra_clause[wtch++] = q;
-      }else if(s->level(var(q)) >= extra_backtrack_level)
-	extra_backtrack_level = s->level(var(q));
-      j++;
+    bool spread = false;
+    int  nodes  = 1;
+    for(int t = 0; t < nbThreads && numa; t++){
+      spread |= cpuNode(t) != cpuNode(0);
+      if (cpuNode(t) >= nodes) nodes = cpuNode(t) + 1;
     }
-    
-    
-    //conflict clause at level 0 --> formula is UNSAT
-    if(extra_clause.size() == 0) 
-      setAnswer(id, l_False);
-    
-    // case of unit extra clause
-    else if(extra_clause.size() == 1){
-      s->cancelUntil(0);
-      if(s->value(extra_clause[0]) == l_Undef){
-	s->uncheckedEnqueue(extra_clause[0]);
-	CRef cs = s->propagate();
-	if(cs != CRef_Undef) answers[id] = l_False;
+    if (!spread) return;
+
+    replicas.growTo(nodes, NULL);
+#pragma omp parallel num_threads(nbThreads)
+    for(int t = omp_get_thread_num(); t < nbThreads; t += omp_get_num_threads()){
+      bool first = true;
+      for(int u = 0; u < t; u++)
+	first &= cpuNode(u) != cpuNode(t);
+      if (first){
+	pinThread(t);
+	Replica* r = new Replica;
+	list_transactions.copyTo(r->trans);
+	wItemTrans       .copyTo(r->util);
+	appearTrans      .copyTo(r->appear);
+	replicas[cpuNode(t)] = r;
       }
     }
-    
-    else {
-      // build clause from lits and add it to learnts(s) base
-      CRef cr = s->addExtraClause(extra_clause);
-      
-      // Case of Unit propagation: literal to propagate or bad level  
-      if(wtch == 1 && (s->value(extra_clause[0]) == l_Undef || extra_backtrack_level < s->level(var(extra_clause[0])))){
-	s->cancelUntil(extra_backtrack_level);
-	s->uncheckedEnqueue(extra_clause[0], cr);
-      }
-      
-      // Case of Conflicting Extra Clause --> analyze that conflict
-      else if(wtch == 0) {
-	extra_clause.clear();
-	s->cancelUntil(extra_backtrack_level);
-	
-	s->analyze(cr, extra_clause, extra_backtrack_level);	
-	s->cancelUntil(extra_backtrack_level);
-	
-	// analyze lead to unit clause
-	if(extra_clause.size() == 1){				
-	  assert(extra_backtrack_level == 0);
-	  if(s->value(extra_clause[0]) == l_Undef)s->uncheckedEnqueue(extra_clause[0]);
-	}
-	// analyze lead to clause with size > 1
-	else {
-	  CRef cs = s->addExtraClause(extra_clause);
-	  s->uncheckedEnqueue(extra_clause[0], cs);
-	  //exportExtraClause(s, extra_clause);		
-	}
-      }
+    for(int t = 0; t < nbThreads; t++){
+      Replica* r = replicas[cpuNode(t)];
+      solvers[t].dbTrans  = &r->trans;
+      solvers[t].dbUtil   = &r->util;
+      solvers[t].dbAppear = &r->appear;
     }
-    
-    nbImportedExtraClauses[id]++;
-    pairwiseImportedExtraClauses[t][id] ++;
-    
-    delete [] lt;
-  }		      
-  
-
+  }
 
 
   /*_________________________________________________________________________________________________
     |
-    |  addExtraClause : ()  ->  [void]
-    |  Description: watch lits correctly and testing basic cases and
-    |  build a clause from the learnt Extra Lit* 
+    |  LaunchSolvers : ()  ->  [void]
+    |  Description : mine every guiding path, each thread pulling them with nextGuidingPath(). One
+    |  more thread runs the writer if the itemsets are written out; the top-k ones are written last.
+    |  A thread is idle for 'mineTime - solvers[t].solveTime' at the end, once no path is left.
     |________________________________________________________________________________________________@*/
-  
-  void Cooperation::addExtraClause1(Solver* s, int t, Lit* lt){
-    
-    int id = s->threadId;
-    int size = var(lt[0]);
-    
-    vec<Lit> lits;
-    int j = 0;
-    int k = 0;
-    Lit q        = lit_Undef;
-    int maxLevel = 0;
-    
-    for(int i=1; i < size+1; i++) {
-      Lit q = lt[i];
-      if(s->value(q) == l_False && s->level(var(q)) == 0)
-	continue;
-      lits.push(lt[i]);
-      if(s->value(q) != l_False){
-	lits[k]   = lits[j];
-	lits[j++] = q;
-      }else if(s->level(var(q)) >= maxLevel)
-	maxLevel = s->level(var(q));
-      k++;
-    }
-    
-    //conflict clause at level 0
-    if(lits.size() == 0) 
-      setAnswer(id, l_False);  
-    
-    // case of unit extra clause 
-    else if(lits.size() == 1){
-      s->cancelUntil(0);
-      if(s->value(lits[0]) == l_Undef)s->uncheckedEnqueue(lits[0]);
+
+  void Cooperation::LaunchSolvers(){
+    start = true;
+    placeThreads();
+#ifdef USE_MPI
+    distStart();
+#endif
+    double t0 = omp_get_wtime();
+#pragma omp parallel num_threads(nbThreads + (out != NULL))
+    {
+      int t = omp_get_thread_num();
+      // a team short of the writer thread (OMP_DYNAMIC, OMP_THREAD_LIMIT) mines with the threads it has
+      if (t == 0 && out != NULL && omp_get_num_threads() <= nbThreads)
+	out->noWriter();
+      if (t == nbThreads)
+	out->run();
+      else{
+	if (pin) pinThread(t);
+	double t1 = omp_get_wtime();
+	solvers[t].EncodeDB(this);
+	solvers[t].solve_(this);
+	solvers[t].solveTime = omp_get_wtime() - t1;
+	if (out != NULL) out->finish(t);
+      }
     }
-    else {
-      // build clause from lits
-      s->addExtraClause(lits);
+    mineTime = omp_get_wtime() - t0;
+#ifdef USE_MPI
+    distGather(*this);
+#endif
+    if (out != NULL){
+      if (topk > 0) writeTopItemsets();
+      out->close();
     }
-    
-    nbImportedExtraClauses[id]++;
-    pairwiseImportedExtraClauses[t][id]++;
-    
-    delete [] lt;
   }
-    
 
-  /*_________________________________________________________________________________________________
-    |
-    |  addExtraClause : ()  ->  [void]
-    |  Description: build a clause from the learnt Extra Lit*
-    |________________________________________________________________________________________________@*/
-  
-  void Cooperation::addExtraClause2(Solver* s, int t, Lit* lt){
-    
-    int id = s->threadId;
-    int size = var(lt[0]);
-    vec<Lit> lits;
-    
-    for(int i=1; i < size+1; i++) 
-      lits.push(lt[i]);
-    
-    // build clause from lits
-    s->addExtraClause(lits);
-    
-    nbImportedExtraClauses[id]++;
-    pairwiseImportedExtraClauses[t][id]++;
-    
-    delete [] lt;
-  }
-  
-    /*_________________________________________________________________________________________________
-    |
-    |  printExMatrix : ()  ->  [void]
-    |  Description: print the final values of size clauses shared between parwise threads
-    |________________________________________________________________________________________________@*/
-  
-  void Cooperation::printExMatrix(){
-    
-    printf("\n Final Matrix extra shared clauses limit size \n");
-    printf(" ----------------------------------------------------\n");
-    for(int i = 0; i < nbThreads; i++){
-      printf("|");  
-      for(int j = 0; j < nbThreads; j++)
-	if(i != j)
-	  printf(" e(%d,%d)=%3d  ", i, j, (int)pairwiseLimitExportClauses[i][j]);
-	else
-	  printf(" e(%d,%d)=%3d  ", i, j, 0);
-      printf(" |\n");
-    }
-    printf(" ----------------------------------------------------\n\n");
-  }
+
  
 }
@@ -19,167 +19,151 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include "core/SolverTypes.h"
 #include "core/Solver.h"
+#include "core/Output.h"
 
 
 namespace Minisat {
 
-//=================================================================================================
-// Options:
-
-#define MAX_EXTRA_CLAUSES     2000
-#define MAX_EXTRA_UNITS       2000
-
-#define MAX_IMPORT_CLAUSES    4000
-#define LIMIT_CONFLICTS_EVAL  6000
-
-#define INITIAL_DET_FREQUENCE 700
-
-#define AIMDX  0.25
-#define AIMDY  8
-
-
+class Checkpoint;
 
 /*=================================================================================================
  Cooperation Class : ->  [class]
 Description:
-	This class manage clause sharing component between threads,i.e.,
-	It controls read and write operations in extraUnits and extraClauses arrays
-    iterators headExtra... and tailExtra... are used to to this end
+	The database and guiding paths shared by the threads, each with its own solver: a thread takes
+	the next guiding path and mines it alone. The threads share no clauses: a clause learnt in a
+	path depends on the literals of that path.
 =================================================================================================*/
   
   class Cooperation{
     
   public:
+
+    struct Replica {                             // copy of the database read by the threads of a NUMA node
+        Csr<Lit>   trans;
+        Csr<int>   util;
+        Csr<int>   appear;
+    };
+
+    struct TopUtil_lt {
+        const vec<int>&  util;
+        bool operator () (int x, int y) const { return util[x] < util[y]; }
+        TopUtil_lt(const vec<int>&  u) : util(u) { }
+    };
     
     bool		start, end;				// start and end multi-threads search
     int			nbThreads;				// numbe of  threads
-    int			limitExportClauses;			// initial limit size of shared clauses
-    double**	        pairwiseLimitExportClauses;		// pairwised limit limit size clause sharing
     int                 div_begining;
+    int                 nextPath;                               // next guiding path to hand out (shared by all threads)
     Solver*		solvers;				// set of running CDCL algorithms	
     lbool*		answers;				// answer of threads
     
-    Lit***		extraUnits;				// where are stored the shared unit clauses 
-    int**		headExtraUnits;
-    int**		tailExtraUnits;					
-    
-    Lit****		extraClauses;				// where are stored the set of shared clauses with size > 1
-    int**		headExtraClauses;
-    int**		tailExtraClauses;				
-    
-    
-    int*		nbImportedExtraUnits;                   // counters fot the total imported Unit clauses
-    int*		nbImportedExtraClauses;			// counters fot the total imported Extra clauses
-    
-    char		ctrl;					// activate control clause sharing size mode
     char                enum_clos;
-    int**		pairwiseImportedExtraClauses;		// imported clause of for and from each thread
+    char                bitset;                  // support and closure on tidsets instead of clauses
+    char                countOnly;               // only count the itemsets, see 'Solver::utilHist'
     
     int                 min_supp;
-    vec<vec<Lit> >      VecGuiding;
-    vec<vec<Lit> >      list_transactions;       // List of transactions
-    vec<vec<int> >      wItemTrans;
+    vec<int>            sweep;                   // minutils mined at once, increasing (the first is min_supp)
+    int                 nbItems;                 // items of the database (variables of each solver)
+    vec<vec<Lit> >      VecGuiding;              // guiding paths, most expensive first: [item, secondary literals...]
+    vec<int>            guidingIndex;            // position (+1) in allItems of the item of each guiding path
+    vec<double>         guidingCost;             // estimated cost of each guiding path
+    int                 splitWidth;              // max number of second items a heavy path is split over
+    int                 smallPath;               // paths of at most so many distinct transactions are not encoded (<= 64)
+    double              mineTime;                // wall time of LaunchSolvers()
+    Csr<Lit>            list_transactions;       // items of each transaction ...
+    Csr<int>            wItemTrans;              // ... and their utilities (same shape)
     vec<int>            wTrans;
-    vec<vec<int> >      appearTrans;
+    Csr<int>            appearTrans;             // transactions of each item, see 'countItems()'
+    int                 firstNew;                // only the itemsets of the transactions from this one on are mined
+                                                 // (0: all), see 'Increment'
     vec<int> occ;
     vec<vec<Lit> >      correl;
     vec<int>            wocc;
+    vec<Var>            itemOrder;               // items by increasing support (ties by index), see 'countItems()'
+    vec<Var>            itemName;                // original number of each item, see 'pruneItems()'
+    Csr<Var>            itemAlso;                // original numbers of the items merged into each item (closed mode)
+    int                 topk;                    // keep the k itemsets of highest utility (0: all above minutil)
+    vec<vec<Var> >      topSets;                 // best itemsets found so far (input items) ...
+    vec<int>            topUtil;                 // ... their utility and support ...
+    vec<int>            topSup;
+    Heap<TopUtil_lt>    topHeap;                 // ... and a min-heap of them on it
+    ItemsetWriter*      out;                     // output of the itemsets (NULL: none) ...
+    ItemsetCallback     callback;                // ... or the function receiving them (NULL: none)
+    void*               callbackData;
+    Checkpoint*         checkpoint;              // journal of the finished guiding paths (NULL: none), skipped if resumed
+    char                pin;                     // bind each thread to a CPU, see 'pinThread()'
+    char                numa;                    // ... and copy the database to each NUMA node the threads run on:
+    vec<Replica*>       replicas;                // the copy of each node (NULL: none), see 'placeThreads()'
     //=================================================================================================
     
-    void exportExtraUnit		(Solver* s, Lit unit);
-    void importExtraUnits		(Solver* s);
-    void importExtraUnits		(Solver* s, vec<Lit>& lits);
-    
-    void exportExtraClause		(Solver* s, vec<Lit>& learnt);
-    void exportExtraClause		(Solver* s, Clause& c);
-    void importExtraClauses		(Solver* s);
-    
-    void addExtraClause			(Solver* s, int t, Lit* lt);
-    void addExtraClause1		(Solver* s, int t, Lit* lt);
-    void addExtraClause2		(Solver* s, int t, Lit* lt);
-
-    void uncheckedEnqueue               (Solver* s, int t, Lit l);
-    void storeExtraUnits                (Solver* s, int t, Lit l, vec<Lit>& lits);
-
     bool inferieur                      (vec<Lit>& vec1, vec<Lit>& vec2);
     void permute                        (vec<Lit>& vec1, vec<Lit>& vec2);
     
     void printStats			(int& id);
-    void printExMatrix			();
     void Parallel_Info			();
+    void copyDatabase                   (Cooperation& from);
+    void countItems                     ();
+    void pruneItems                     ();
+    void allocItems                     ();
+    void addTopItemset                  (vec<Var>& set, int util, int sup);
+    void writeTopItemsets               ();
     void buildGuidingPaths              ();
-    bool addTableClause_                (vec<Lit>& ps);
+    double pathCost                     (int k, vec<Lit>& items, vec<int>& pos, vec<int>& co, vec<Var>& cand);
+    void addGuidingPath                 (vec<Lit>& path, int index, double cost);
+    int  nextGuidingPath                ();
+    void pathDone                       (Solver* s, int path, uint64_t n);
+    bool addTransaction_                (vec<Lit>& items, int tu, vec<int>& util);
     bool addWeightedItems_              (vec<int>& ps);
     
+    void placeThreads                   ();
     void LaunchSolvers                  ();
 
     
     //=================================================================================================
     inline int nThreads      ()			{return nbThreads;		}
-    inline int limitszClauses()			{return limitExportClauses;	}
     inline lbool answer      (int t)		{return answers[t];		}
     inline bool setAnswer    (int id, lbool lb) {answers[id] = lb; return true;	}
+    inline int threshold     ()			{int m;
+#pragma omp atomic read
+                                                 m = min_supp;
+                                                 return m;			}
+    inline bool wantItems    ()			{return !countOnly && (topk > 0 || out != NULL || callback != NULL); }
     
     //=================================================================================================
     // Constructor / Destructor 
     
-    Cooperation(int n, int l){
+    Cooperation(int n) : topHeap(TopUtil_lt(topUtil)) {
       
-      limitExportClauses = l;
       nbThreads	= n;
       end         = false;
+      nextPath    = 0;
+      splitWidth  = 0;
+      smallPath   = 0;
+      firstNew    = 0;
+      mineTime    = 0;
+      bitset      = 0;
+      countOnly   = 0;
+      nbItems     = 0;
+      topk        = 0;
+      out         = NULL;
+      callback    = NULL;
+      callbackData= NULL;
+      checkpoint  = NULL;
+      pin         = 0;
+      numa        = 0;
       solvers	            = new Solver    [nbThreads];
       answers	            = new lbool     [nbThreads];		
       
-      extraUnits            = new Lit**     [nbThreads];
-      headExtraUnits        = new int*      [nbThreads];
-      tailExtraUnits        = new int*      [nbThreads];
-
-      extraClauses          = new Lit***    [nbThreads];
-      headExtraClauses      = new int*      [nbThreads];
-      tailExtraClauses      = new int*      [nbThreads];
-      
-      for(int t = 0; t < nbThreads; t++){
-	extraUnits	  [t]    = new Lit* [nbThreads];
-	headExtraUnits	  [t]    = new int  [nbThreads];
-	tailExtraUnits	  [t]    = new int  [nbThreads];
-
-	extraClauses	  [t]    = new Lit**[nbThreads];
-	headExtraClauses  [t]    = new int  [nbThreads];
-	tailExtraClauses  [t]    = new int  [nbThreads];
-	
-	for(int k = 0; k < nbThreads; k++){
-	  extraUnits	  [t][k] = new Lit  [MAX_EXTRA_UNITS];
-	  headExtraUnits  [t][k] = 0;
-	  tailExtraUnits  [t][k] = 0;
-	  
-	  extraClauses	  [t][k] = new Lit* [MAX_EXTRA_CLAUSES];					
-	  headExtraClauses[t][k] = 0;
-	  tailExtraClauses[t][k] = 0;
-	}
-	}
-      
-      //=================================================================================================
-      nbImportedExtraClauses      = new int	[nbThreads];
-      nbImportedExtraUnits        = new int	[nbThreads];
-      pairwiseImportedExtraClauses= new int*	[nbThreads];
-      pairwiseLimitExportClauses  = new double*	[nbThreads];		
-      
-      for(int t = 0; t < nbThreads; t++){
-	answers               [t] = l_Undef;
-	nbImportedExtraClauses[t] = 0;
-	nbImportedExtraUnits  [t] = 0;
-	
-	pairwiseImportedExtraClauses [t]= new int   [nbThreads];
-	pairwiseLimitExportClauses   [t]= new double[nbThreads];
-	
-	for(int k = 0; k < nbThreads; k++)
-	  pairwiseLimitExportClauses[t][k]= l;
-	
-      }
+      for(int t = 0; t < nbThreads; t++)
+	answers[t] = l_Undef;
       }
     //=================================================================================================
-    ~Cooperation(){}				
+    ~Cooperation(){
+      for(int i = 0; i < replicas.size(); i++)
+	delete replicas[i];
+      delete [] answers;
+      delete [] solvers;
+    }
   };
 }
 
@@ -22,8 +22,16 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #define Minisat_Dimacs_h
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <omp.h>
+#include <string.h>
 
 #include "core/Cooperation.h"
+#include "core/Distributed.h"
 #include "utils/ParseUtils.h"
 #include "core/SolverTypes.h"
 
@@ -32,36 +40,60 @@ namespace Minisat {
 //=================================================================================================
 // DIMACS Parser:
 
-template<class B, class Cooperation>
-static void readClause(B& in, Cooperation* coop, vec<Lit>& lits) {
-    int     parsed_lit, var;
-    lits.clear();
-    int cpt = 1;
+// Two line formats are read, told apart by the separator after the items:
+//
+//    items -1 TU -1 utilities 0       (the DIMACS-like format of the solver)
+//    items:TU:utilities               (the SPMF format, one transaction per line)
+//
+// Comment lines start with 'c' or 'p' (DIMACS), '#', '%' or '@' (SPMF).
+
+static inline bool isCommentStart(int c) {
+    return c == 'c' || c == 'p' || c == '#' || c == '%' || c == '@'; }
+
+
+template<class B>
+static void readTransaction(B& in, vec<Lit>& items, int& tu, vec<int>& util, int& nbItems) {
+    items.clear();
+    util .clear();
+    bool spmf;
     for (;;){
-        parsed_lit = parseInt(in);
-        if (parsed_lit == 0) break;
-	if(parsed_lit == -1)
-	  cpt = 0;
-        var = abs(parsed_lit)-1;
-	int initvar = var;
-	if(cpt == 1){
-	  for(int t = 0; t < coop->nbThreads; t++){
-	    var = initvar;	
-	    while (var >= coop->solvers[t].nVars()) coop->solvers[t].newVar();
-	  }	
-	}
-	lits.push( (parsed_lit > 0) ? mkLit(var, false) : ~mkLit(var, false) );
-	
+        skipWhitespace(in);
+        if (*in == ':'){ spmf = true; ++in; break; }
+        int x = parseInt(in);
+        if (x == -1){ spmf = false; break; }
+        if (x <= 0) fprintf(stderr, "PARSE ERROR! Unexpected item: %d\n", x), exit(3);
+        items.push(mkLit(x-1, false));
+        if (x > nbItems) nbItems = x;
+    }
+    tu = parseInt(in);
+    if (spmf){
+        skipBlanks(in);
+        if (*in != ':') fprintf(stderr, "PARSE ERROR! Expected ':' after the utility of a transaction\n"), exit(3);
+        ++in;
+        for (;;){
+            skipBlanks(in);
+            if (isEof(in) || *in == '\n') break;
+            util.push(parseInt(in)); }
+    }else{
+        if (parseInt(in) != -1) fprintf(stderr, "PARSE ERROR! Expected -1 after the utility of a transaction\n"), exit(3);
+        int x;
+        while ((x = parseInt(in)) != 0)
+            util.push(x);
     }
+    if (util.size() != items.size())
+        fprintf(stderr, "PARSE ERROR! %d utilities for %d items in a transaction\n", util.size(), items.size()), exit(3);
 }
- 
+
 
 template<class B, class Cooperation>
 static void parse_DIMACS_main(B& in, Cooperation* coop) {
-    vec<Lit> lits;
+    vec<Lit> items;
+    vec<int> util;
+    int tu;
     int vars    = 0;
     int clauses = 0;
     int cnt     = 0;
+    int nbItems = 0;
     for (;;){
         skipWhitespace(in);
         if (*in == EOF) break;
@@ -75,12 +107,12 @@ static void parse_DIMACS_main(B& in, Cooperation* coop) {
             }else{
                 printf("PARSE ERROR! Unexpected char: %c\n", *in), exit(3);
             }
-        } else if (*in == 'c' || *in == 'p')
+        } else if (isCommentStart(*in))
             skipLine(in);
         else{
             cnt++;
-	      readClause(in, coop, lits);
-	      coop->addTableClause_(lits);
+	      readTransaction(in, items, tu, util, nbItems);
+	      coop->addTransaction_(items, tu, util);
 
 	     //for(int t = 1; t < coop->nbThreads; t++)
 	    // coop->solvers[t].addClause(lits);
@@ -90,8 +122,7 @@ static void parse_DIMACS_main(B& in, Cooperation* coop) {
 	     // coop->solvers[t].addClause(lits); }
     }
 
-
-    coop->buildGuidingPaths();
+    if (nbItems > coop->nbItems) coop->nbItems = nbItems;
     
     /* 
     if (vars != coop->solvers[0].nVars())
@@ -107,6 +138,307 @@ static void parse_DIMACS(gzFile input_stream, Cooperation* coop) {
     StreamBuffer in(input_stream);
     parse_DIMACS_main(in, coop); }
 
+
+//=================================================================================================
+// Memory-mapped parallel loader for uncompressed files:
+
+
+// One chunk of the file, parsed independently of the others:
+struct DBChunk {
+    const char*     beg;
+    const char*     end;
+    Csr<Lit>        items;
+    vec<int>        tu;
+    Csr<int>        util;
+    int             nbItems;
+};
+
+
+static inline int parseMappedInt(const char*& p, const char* end) {
+    while (p < end && ((*p >= 9 && *p <= 13) || *p == 32)) p++;
+    bool neg = false;
+    if      (p < end && *p == '-') neg = true, p++;
+    else if (p < end && *p == '+') p++;
+    if (p >= end || *p < '0' || *p > '9') fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", p < end ? *p : ' '), exit(3);
+    int val = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+        val = val*10 + (*p++ - '0');
+    return neg ? -val : val; }
+
+
+// Parses the transactions of a chunk in either format (see 'readTransaction()'), skipping comments.
+static void parseChunk(DBChunk& c) {
+    const char* p = c.beg;
+    c.nbItems = 0;
+    for (;;){
+        while (p < c.end && ((*p >= 9 && *p <= 13) || *p == 32)) p++;
+        if (p >= c.end) break;
+        if (isCommentStart(*p)){
+            while (p < c.end && *p != '\n') p++;
+            continue; }
+
+        c.items.push();
+        c.util .push();
+        int  x, n = 0;
+        bool spmf;
+        for (;;){
+            while (p < c.end && ((*p >= 9 && *p <= 13) || *p == 32)) p++;
+            if (p < c.end && *p == ':'){ spmf = true; p++; break; }
+            if ((x = parseMappedInt(p, c.end)) == -1){ spmf = false; break; }
+            if (x <= 0) fprintf(stderr, "PARSE ERROR! Unexpected item %d in transaction %d\n", x, c.items.size()), exit(3);
+            c.items.push(mkLit(x-1, false)), n++;
+            if (x > c.nbItems) c.nbItems = x; }
+        c.tu.push(parseMappedInt(p, c.end));
+        if (spmf){
+            while (p < c.end && (*p == 9 || *p == 13 || *p == 32)) p++;
+            if (p >= c.end || *p != ':') fprintf(stderr, "PARSE ERROR! Expected ':' after the utility of transaction %d\n", c.items.size()), exit(3);
+            p++;
+            for (;;){
+                while (p < c.end && (*p == 9 || *p == 13 || *p == 32)) p++;
+                if (p >= c.end || *p == '\n') break;
+                c.util.push(parseMappedInt(p, c.end)), n--; }
+        }else{
+            if (parseMappedInt(p, c.end) != -1) fprintf(stderr, "PARSE ERROR! Expected -1 after the utility of transaction %d\n", c.items.size()), exit(3);
+            while ((x = parseMappedInt(p, c.end)) != 0)
+                c.util.push(x), n--;
+        }
+        if (n != 0) fprintf(stderr, "PARSE ERROR! Not as many utilities as items in transaction %d\n", c.items.size()), exit(3);
+    }
+}
+
+
+// Next chunk boundary after 'p': the start of a line following a transaction terminator '0', or
+// of any line in the SPMF format.
+static const char* chunkBoundary(const char* p, const char* beg, const char* end, bool spmf) {
+    for (;;){
+        while (p < end && *p != '\n') p++;
+        if (p >= end) return end;
+        const char* q = p;
+        while (q > beg && (q[-1] == ' ' || q[-1] == '\t' || q[-1] == '\r')) q--;
+        p++;
+        if (spmf || (q > beg && q[-1] == '0' && (q - 1 == beg || q[-2] == ' ' || q[-2] == '\t')))
+            return p;
+    }
+}
+
+
+// Whether the first transaction of the file is in the SPMF format (a ':' on its line).
+static bool isSpmf(const char* p, const char* end) {
+    for (;;){
+        while (p < end && ((*p >= 9 && *p <= 13) || *p == 32)) p++;
+        if (p >= end || !isCommentStart(*p)) break;
+        while (p < end && *p != '\n') p++; }
+    while (p < end && *p != '\n' && *p != ':') p++;
+    return p < end && *p == ':';
+}
+
+
+// Loads an uncompressed file in 'n' chunks, parsed in parallel. Returns false if the file cannot
+// be mapped or is gzipped, in which case the caller falls back on 'parse_DIMACS()'.
+//
+template<class Cooperation>
+static bool parse_mapped(const char* path, Cooperation* coop, int n) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0){
+        close(fd); return false; }
+    const char* data = (const char*)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+    const char* end = data + st.st_size;
+    if (st.st_size >= 2 && (unsigned char)data[0] == 0x1f && (unsigned char)data[1] == 0x8b){
+        munmap((void*)data, st.st_size); return false; }
+    madvise((void*)data, st.st_size, MADV_SEQUENTIAL);
+
+    bool     spmf   = isSpmf(data, end);
+    DBChunk* chunks = new DBChunk[n];
+    const char* p = data;
+    for (int i = 0; i < n; i++){
+        const char* target = data + (st.st_size / n) * (i+1);
+        chunks[i].beg = p;
+        chunks[i].end = p = (i == n-1) ? end : chunkBoundary(target > p ? target : p, data, end, spmf); }
+
+#pragma omp parallel for
+    for (int i = 0; i < n; i++)
+        parseChunk(chunks[i]);
+
+    // Append the chunks in order to the shared database:
+    int nbItems = 0, size = coop->list_transactions.size(), nelems = coop->list_transactions.elems();
+    for (int i = 0; i < n; i++){
+        size    += chunks[i].items.size();
+        nelems  += chunks[i].items.elems();
+        nbItems  = chunks[i].nbItems > nbItems ? chunks[i].nbItems : nbItems; }
+    coop->list_transactions.capacity(size, nelems);
+    coop->wItemTrans       .capacity(size, nelems);
+    coop->wTrans           .capacity(size);
+    for (int i = 0; i < n; i++){
+        coop->list_transactions.append(chunks[i].items);
+        coop->wItemTrans       .append(chunks[i].util);
+        for (int j = 0; j < chunks[i].tu.size(); j++)
+            coop->wTrans.push(chunks[i].tu[j]); }
+
+    delete [] chunks;
+    munmap((void*)data, st.st_size);
+
+    if (nbItems > coop->nbItems) coop->nbItems = nbItems;
+    return true;
+}
+
+
+//=================================================================================================
+// Binary database cache:
+//
+// A header, then as 'int' arrays: the transactions in CSR form (offsets, items, utilities), their
+// utility, the item occurrences in CSR form (offsets, transactions), support, TWU and item order
+// of 'Cooperation::countItems()'. It is tied to the size and modification time of its source.
+
+
+struct DBCacheHeader {
+    char     magic[8];
+    uint64_t srcSize;
+    int64_t  srcMtime;
+    int      nbItems;
+    int      nbTrans;
+    int      nbOcc;
+    int      pad;
+};
+
+static const char dbCacheMagic[8] = { 'S', 'C', 'H', 'U', 'I', 'M', 'D', '1' };
+
+
+static bool writeInts(FILE* f, const int* a, int n) { return n == 0 || fwrite(a, sizeof(int), n, f) == (size_t)n; }
+
+
+// Writes the cache of 'path' (loaded and counted) to 'cache'. Returns false on failure.
+//
+template<class Cooperation>
+static bool save_cache(const char* path, const char* cache, Cooperation* coop) {
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+    FILE* f = fopen(cache, "wb");
+    if (f == NULL) return false;
+
+    DBCacheHeader h;
+    memcpy(h.magic, dbCacheMagic, sizeof(h.magic));
+    h.srcSize  = st.st_size;
+    h.srcMtime = st.st_mtime;
+    h.nbItems  = coop->itemOrder.size();
+    h.nbTrans  = coop->list_transactions.size();
+    h.nbOcc    = coop->list_transactions.elems();
+    h.pad      = 0;
+
+    bool     ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    vec<int> a;
+    a.push(0);
+    for (int i = 0; i < h.nbTrans; i++) a.push(a.last() + coop->list_transactions.size(i));
+    ok = ok && writeInts(f, &a[0], a.size()); a.clear();
+    for (int i = 0; i < h.nbTrans; i++) for (int j = 0; j < coop->list_transactions.size(i); j++) a.push(var(coop->list_transactions[i][j]));
+    ok = ok && writeInts(f, &a[0], a.size()); a.clear();
+    ok = ok && coop->wItemTrans.elems() == h.nbOcc && (h.nbOcc == 0 || writeInts(f, coop->wItemTrans[0], h.nbOcc));
+    ok = ok && writeInts(f, &coop->wTrans[0], h.nbTrans);
+    a.push(0);
+    for (int i = 0; i < h.nbItems; i++) a.push(a.last() + coop->appearTrans.size(i));
+    ok = ok && writeInts(f, &a[0], a.size()); a.clear();
+    ok = ok && coop->appearTrans.elems() == h.nbOcc && (h.nbOcc == 0 || writeInts(f, coop->appearTrans[0], h.nbOcc));
+    ok = ok && writeInts(f, &coop->occ[0], h.nbItems) && writeInts(f, &coop->wocc[0], h.nbItems) && writeInts(f, &coop->itemOrder[0], h.nbItems);
+
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) ::remove(cache);
+    return ok;
+}
+
+
+// Loads the database of 'path' from 'cache' if it is up to date. Returns false otherwise.
+//
+template<class Cooperation>
+static bool load_cache(const char* path, const char* cache, Cooperation* coop) {
+    struct stat src, st;
+    if (stat(path, &src) != 0) return false;
+    int fd = open(cache, O_RDONLY);
+    if (fd < 0) return false;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(DBCacheHeader)){
+        close(fd); return false; }
+    const char* data = (const char*)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+
+    const DBCacheHeader& h = *(const DBCacheHeader*)data;
+    int nT = h.nbTrans, nI = h.nbItems, nO = h.nbOcc;
+    bool valid = memcmp(h.magic, dbCacheMagic, sizeof(h.magic)) == 0
+              && h.srcSize == (uint64_t)src.st_size && h.srcMtime == (int64_t)src.st_mtime
+              && nT >= 0 && nI >= 0 && nO >= 0
+              && (size_t)st.st_size == sizeof(h) + sizeof(int) * ((size_t)nT+1 + 2*(size_t)nO + nT + nI+1 + nO + 3*(size_t)nI);
+    if (!valid){
+        munmap((void*)data, st.st_size); return false; }
+
+    const int* tbeg  = (const int*)(data + sizeof(h));
+    const int* titem = tbeg  + nT + 1;
+    const int* tutil = titem + nO;
+    const int* tu    = tutil + nO;
+    const int* ibeg  = tu    + nT;
+    const int* itid  = ibeg  + nI + 1;
+    const int* occ   = itid  + nO;
+    const int* wocc  = occ   + nI;
+    const int* order = wocc  + nI;
+
+    coop->list_transactions.capacity(nT, nO);
+    coop->wItemTrans       .capacity(nT, nO);
+    coop->wTrans           .capacity(nT);
+    for (int i = 0; i < nT; i++){
+        coop->list_transactions.push();
+        coop->wItemTrans       .push();
+        for (int j = tbeg[i]; j < tbeg[i+1]; j++){
+            coop->list_transactions.push(mkLit(titem[j], false));
+            coop->wItemTrans       .push(tutil[j]); }
+        coop->wTrans.push(tu[i]); }
+
+    coop->appearTrans.clear();
+    coop->appearTrans.capacity(nI, nO);
+    for (int i = 0; i < nI; i++){
+        coop->appearTrans.push();
+        for (int j = ibeg[i]; j < ibeg[i+1]; j++)
+            coop->appearTrans.push(itid[j]);
+        coop->occ      .push(occ[i]);
+        coop->wocc     .push(wocc[i]);
+        coop->itemOrder.push(order[i]); }
+
+    munmap((void*)data, st.st_size);
+    coop->nbItems = nI;
+    return true;
+}
+
+
+// Loads and counts the database of 'path' (NULL: the standard input): from its cache if 'cache' is
+// set and the cache is up to date, which is written otherwise. A file is parsed in 'parts' chunks
+// (0: one per thread of 'coop'). Returns false if it can't be read.
+//
+template<class Cooperation>
+static bool load_database(const char* path, Cooperation* coop, bool cache, int parts = 0) {
+    char* cacheFile = NULL;
+    if (cache && path != NULL){
+        cacheFile = (char*)malloc(strlen(path) + 5);
+        sprintf(cacheFile, "%s.bin", path); }
+
+    bool ok = true;
+    if (cacheFile == NULL || !load_cache(path, cacheFile, coop)){
+        if (path == NULL || !parse_mapped(path, coop, parts > 0 ? parts : coop->nbThreads)){
+            gzFile in = (path == NULL) ? gzdopen(0, "rb") : gzopen(path, "rb");
+            if (in == NULL) ok = false;
+            else            parse_DIMACS(in, coop), gzclose(in); }
+        if (ok){
+            coop->countItems();
+            bool write = cacheFile != NULL;
+#ifdef USE_MPI
+            write = write && distRank() == 0;    // one process writes it
+#endif
+            if (write && !save_cache(path, cacheFile, coop))
+                printf("WARNING! Could not write the database cache %s\n", cacheFile); }
+    }
+    free(cacheFile);
+    return ok;
+}
+
 //=================================================================================================
 }
 
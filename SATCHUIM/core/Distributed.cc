@@ -0,0 +1,112 @@
+#ifdef USE_MPI
+
+#include <mpi.h>
+
+#include "core/Cooperation.h"
+#include "core/Distributed.h"
+
+using namespace Minisat;
+
+static int     rank  = 0;
+static int     nodes = 1;
+static MPI_Win pathWin;
+static int*    pathCounter;
+
+
+void Minisat::distInit(int* argc, char*** argv)
+{
+    int provided;
+    MPI_Init_thread(argc, argv, MPI_THREAD_SERIALIZED, &provided);
+    if (provided < MPI_THREAD_SERIALIZED)
+        fprintf(stderr, "ERROR! The MPI library does not support threads\n"), MPI_Abort(MPI_COMM_WORLD, 1);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nodes);
+}
+
+
+void Minisat::distFinish() { MPI_Finalize(); }
+int  Minisat::distRank  () { return rank; }
+int  Minisat::distSize  () { return nodes; }
+
+
+void Minisat::distStart()
+{
+    MPI_Win_allocate(rank == 0 ? sizeof(int) : 0, sizeof(int), MPI_INFO_NULL, MPI_COMM_WORLD, &pathCounter, &pathWin);
+    if (rank == 0) *pathCounter = 0;
+    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_Win_lock_all(0, pathWin);
+}
+
+
+// The threads of a process call MPI one at a time (MPI_THREAD_SERIALIZED):
+int Minisat::distNextPath()
+{
+    int one = 1, k;
+#pragma omp critical(mpi)
+    {
+        MPI_Fetch_and_op(&one, &k, MPI_INT, 0, 0, MPI_SUM, pathWin);
+        MPI_Win_flush(0, pathWin);
+    }
+    return k;
+}
+
+
+// Sums 'n' counters of every process into those of process 0.
+static void sumCounters(uint64_t* c, int n)
+{
+    if (n == 0) return;
+    if (rank == 0) MPI_Reduce(MPI_IN_PLACE, c, n, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+    else           MPI_Reduce(c, NULL,        n, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+}
+
+
+void Minisat::distGather(Cooperation& coop)
+{
+    MPI_Win_unlock_all(pathWin);
+    MPI_Win_free(&pathWin);
+
+    // per thread: the number of itemsets, then the histograms of the count-only and sweep modes
+    vec<uint64_t> c;
+    for (int t = 0; t < coop.nbThreads; t++){
+        Solver& s = coop.solvers[t];
+        c.push(s.nbModels);
+        for (int b = 0; b < s.utilHist .size(); b++) c.push(s.utilHist [b]);
+        for (int b = 0; b < s.sweepHist.size(); b++) c.push(s.sweepHist[b]); }
+    sumCounters(&c[0], c.size());
+    for (int t = 0, i = 0; t < coop.nbThreads; t++){
+        Solver& s = coop.solvers[t];
+        s.nbModels = c[i++];
+        for (int b = 0; b < s.utilHist .size(); b++) s.utilHist [b] = c[i++];
+        for (int b = 0; b < s.sweepHist.size(); b++) s.sweepHist[b] = c[i++]; }
+
+    if (coop.topk == 0) return;
+
+    // the top-k itemsets of the other processes, as 'n util sup items..', go to process 0
+    vec<int> mine;
+    if (rank > 0){
+        for (int i = 0; i < coop.topSets.size(); i++){
+            mine.push(coop.topSets[i].size());
+            mine.push(coop.topUtil[i]);
+            mine.push(coop.topSup [i]);
+            for (int j = 0; j < coop.topSets[i].size(); j++)
+                mine.push(coop.topSets[i][j]); }
+        coop.topSets.clear(); coop.topUtil.clear(); coop.topSup.clear(); coop.topHeap.clear();
+    }
+    int      n = mine.size();
+    vec<int> sizes(nodes, 0), offs(nodes, 0), all;
+    MPI_Gather(&n, 1, MPI_INT, &sizes[0], 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (rank == 0){
+        for (int r = 1; r < nodes; r++) offs[r] = offs[r-1] + sizes[r-1];
+        all.growTo(offs[nodes-1] + sizes[nodes-1]); }
+    MPI_Gatherv(mine.size() > 0 ? &mine[0] : NULL, n, MPI_INT, all.size() > 0 ? &all[0] : NULL, &sizes[0], &offs[0], MPI_INT, 0, MPI_COMM_WORLD);
+
+    vec<Var> set;
+    for (int i = 0; i < all.size(); ){
+        set.clear();
+        int k = all[i], util = all[i+1], sup = all[i+2];
+        for (int j = 0; j < k; j++) set.push(all[i+3+j]);
+        coop.addTopItemset(set, util, sup);
+        i += 3 + k; }
+}
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef Minisat_Distributed_h
+#define Minisat_Distributed_h
+
+#ifdef USE_MPI
+
+namespace Minisat {
+
+class Cooperation;
+
+/*=================================================================================================
+ Distributed mining : ->  [functions]
+Description:
+	Built with 'make MPI=1', the guiding paths are mined by several processes: each one loads the
+	database and builds the same guiding paths, then its threads take the next path to mine from a
+	counter held by process 0 (one-sided MPI), as they take it from 'Cooperation::nextPath' in a
+	single process. Afterwards the numbers of itemsets are summed on process 0 and the top-k
+	itemsets merged there. Each process writes its itemsets to its own result file.
+=================================================================================================*/
+
+void distInit      (int* argc, char*** argv);
+void distFinish    ();
+int  distRank      ();
+int  distSize      ();
+
+void distStart     ();                      // collective: sets the shared path counter to 0
+int  distNextPath  ();                      // next guiding path of all the processes
+void distGather    (Cooperation& coop);     // collective: sums the counters, merges the top-k itemsets
+
+//=================================================================================================
+}
+
+#endif
+#endif
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "mtl/Bitset.h"
+#include "core/Cooperation.h"
+#include "core/Incremental.h"
+#include "core/Output.h"
+
+using namespace Minisat;
+
+static const char stateMagic[]  = "SATCHUIM-STATE";
+static const int  stateVersion  = 2;
+
+
+bool Increment::load(const char* state)
+{
+    FILE* f = fopen(state, "r");
+    if (f == NULL) return false;
+    char               tag[32];
+    int                version;
+    unsigned long long h, n;
+    long long          b;
+    bool ok = fscanf(f, "%31s %d", tag, &version) == 2 && strcmp(tag, stateMagic) == 0 && version == stateVersion
+           && fscanf(f, "%d %d %d %llu %llu %lld", &minutil, &closed, &transactions, &h, &n, &b) == 6;
+    fclose(f);
+    hash     = h;
+    itemsets = n;
+    bytes    = b;
+    return ok && transactions >= 0;
+}
+
+
+bool Increment::save(const char* state) const
+{
+    FILE* f = fopen(state, "w");
+    if (f == NULL) return false;
+    fprintf(f, "%s %d\n%d %d %d %llu %llu %lld\n", stateMagic, stateVersion, minutil, closed, transactions,
+            (unsigned long long)hash, (unsigned long long)itemsets, (long long)bytes);
+    return fclose(f) == 0;
+}
+
+
+// FNV-1a over the items and utilities of the first 'n' transactions
+uint64_t Increment::hashTransactions(Cooperation& coop, int n)
+{
+    uint64_t h = 14695981039346656037ull;
+    for (int i = 0; i < n; i++){
+        CsrRow<Lit> trans = coop.list_transactions[i];
+        CsrRow<int> util  = coop.wItemTrans[i];
+        for (int j = 0; j < trans.size(); j++){
+            h = (h ^ (uint32_t)var(trans[j])) * 1099511628211ull;
+            h = (h ^ (uint32_t)util[j])       * 1099511628211ull; }
+        h = (h ^ 0xffffffffu) * 1099511628211ull;
+    }
+    return h;
+}
+
+
+bool Increment::follows(Cooperation& coop)
+{
+    return coop.min_supp == minutil && coop.enum_clos == closed
+        && transactions <= coop.list_transactions.size()
+        && hashTransactions(coop, transactions) == hash;
+}
+
+
+void Increment::record(Cooperation& coop)
+{
+    minutil      = coop.min_supp;
+    closed       = coop.enum_clos;
+    transactions = coop.list_transactions.size();
+    hash         = hashTransactions(coop, transactions);
+}
+
+
+// The size first, then the itemsets read back: a file cut short (or any other) is not taken for it.
+bool Increment::results(const char* previous) const
+{
+    struct stat st;
+    if (stat(previous, &st) != 0 || (int64_t)st.st_size != bytes) return false;
+    ItemsetReader in;
+    vec<int>      items;
+    int           util, sup;
+    uint64_t      n = 0;
+    if (!in.open(previous)) return false;
+    while (in.next(items, util, sup)) n++;
+    return n == itemsets;
+}
+
+
+void Increment::wrote(const char* result, uint64_t n)
+{
+    struct stat st;
+    itemsets = n;
+    bytes    = stat(result, &st) == 0 ? (int64_t)st.st_size : -1;
+}
+
+
+void Increment::index(Cooperation& coop)
+{
+    int first = transactions, n = coop.list_transactions.size() - first;
+    words = bitWords(n);
+    tids.clear();
+    tids.growTo(coop.nbItems * words, 0);
+    for (int i = 0; i < n; i++){
+        CsrRow<Lit> trans = coop.list_transactions[first + i];
+        for (int j = 0; j < trans.size(); j++)
+            bitSet(&tids[var(trans[j]) * words], i);
+    }
+}
+
+
+bool Increment::touched(const vec<int>& items) const
+{
+    if (items.size() == 0 || words == 0) return false;
+    for (int w = 0; w < words; w++){
+        uint64_t x = ~(uint64_t)0;
+        for (int i = 0; i < items.size() && x != 0; i++)
+            x &= items[i] * words < tids.size() ? tids[items[i] * words + w] : 0;
+        if (x != 0) return true;
+    }
+    return false;
+}
+
+
+int Increment::keep(const char* previous, ItemsetWriter* out) const
+{
+    ItemsetReader in;
+    vec<int>      items;
+    int           util, sup, n = 0;
+    if (!in.open(previous)) return -1;
+    while (in.next(items, util, sup))
+        if (!touched(items)){
+            if (out != NULL) out->writeNow(items, util, sup);
+            n++; }
+    return n;
+}
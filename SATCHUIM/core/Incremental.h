@@ -0,0 +1,56 @@
+#ifndef Minisat_Incremental_h
+#define Minisat_Incremental_h
+
+#include "mtl/IntTypes.h"
+#include "mtl/Vec.h"
+
+namespace Minisat {
+
+class Cooperation;
+class ItemsetWriter;
+
+/*=================================================================================================
+ Increment Class : ->  [class]
+Description:
+	Incremental mining of a transaction log that only grows ('-incremental'). A run leaves next to
+	its result file a state '<result>.state': minutil, closedness, how many transactions were mined
+	and a hash of them, and the number of itemsets and bytes of the result file. If the next run
+	finds the same settings, the log still starting with these transactions and the result file as
+	it was left, only the new ones can change anything: an itemset contained in none of them
+	keeps its utility, support and closure. So the itemsets of the previous results outside of the
+	new transactions are copied over, and only the guiding paths of items of the new transactions
+	are mined, for the itemsets of at least one of them (see 'Cooperation::firstNew').
+=================================================================================================*/
+
+  class Increment {
+
+    vec<uint64_t>  tids;                    // new transactions of each item (input numbering), as bitsets ...
+    int            words;                   // ... of this many words
+
+  public:
+    int            minutil;                 // settings and database of the previous run
+    int            closed;
+    int            transactions;
+    uint64_t       hash;
+    uint64_t       itemsets;                // result file of the previous run: its itemsets ...
+    int64_t        bytes;                   // ... and its size
+
+    Increment() : words(0), minutil(0), closed(0), transactions(0), hash(0), itemsets(0), bytes(0) { }
+
+    bool           load     (const char* state);
+    bool           save     (const char* state) const;
+    bool           follows  (Cooperation& coop);       // the database (loaded, not pruned) extends the previous one
+    void           record   (Cooperation& coop);       // the database is the one to mine now
+    bool           results  (const char* previous) const;   // the result file is the one of the previous run
+    void           wrote    (const char* result, uint64_t n);   // the result file of this run holds 'n' itemsets
+    void           index    (Cooperation& coop);       // the transactions after the previous ones are new
+    bool           touched  (const vec<int>& items) const;   // itemset contained in a new transaction
+    int            keep     (const char* previous, ItemsetWriter* out) const;   // copies the untouched itemsets (-1: can't read)
+
+    static uint64_t hashTransactions(Cooperation& coop, int n);
+  };
+
+//=================================================================================================
+}
+
+#endif
@@ -27,7 +27,11 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "utils/System.h"
 #include "utils/ParseUtils.h"
 #include "utils/Options.h"
+#include "mtl/Sort.h"
+#include "core/Checkpoint.h"
 #include "core/Dimacs.h"
+#include "core/Distributed.h"
+#include "core/Incremental.h"
 #include "core/Solver.h"
 
 
@@ -50,21 +54,101 @@ void printStats(Solver& solver)
     printf("  conflict literals     : %-12"PRIu64"   (%4.2f %% deleted)\n", solver.tot_literals, (solver.max_literals - solver.tot_literals)*100 / (double)solver.max_literals);
     //if (mem_used != 0) printf("  Memory used           : %.2f MB\n", mem_used);
     printf("  CPU time              : %g s\n", cpu_time);*/
+    // the rates are those of the thread, over its own wall time (CPU time is that of the process)
+    double wall = solver.solveTime > 0 ? solver.solveTime : cpu_time;
      printf("---------------------------------------------------------------------------------------------------\n");
          printf("                                |-- CPU time    : %g s \n", cpu_time);
+         printf("                                |-- wall time   : %g s \n", wall);
          printf("                                |-- #restarts   : %"PRIu64"\n", solver.starts);
-	 printf("  More statistics               |-- #conflicts  : %-12"PRIu64"  (%.0f /sec) \n", solver.conflicts, solver.conflicts   /cpu_time);
-	 printf("                                |-- #decisions  : %-12"PRIu64"  (%4.2f %% random) (%.0f /sec) \n", solver.decisions, (float)solver.rnd_decisions*100 / (float)solver.decisions, solver.decisions   /cpu_time);
-	 printf("                                |-- #propagations : %-12"PRIu64"  (%.0f /sec) \n", solver.propagations, solver.propagations/cpu_time);
+	 printf("  More statistics               |-- #conflicts  : %-12"PRIu64"  (%.0f /sec) \n", solver.conflicts, solver.conflicts   /wall);
+	 printf("                                |-- #decisions  : %-12"PRIu64"  (%4.2f %% random) (%.0f /sec) \n", solver.decisions, (float)solver.rnd_decisions*100 / (float)solver.decisions, solver.decisions   /wall);
+	 printf("                                |-- #propagations : %-12"PRIu64"  (%.0f /sec) \n", solver.propagations, solver.propagations/wall);
 	 printf("                                |-- #conflict literals   : %-12"PRIu64"  (%4.2f %% deleted) \n", solver.tot_literals, (solver.max_literals - solver.tot_literals)*100 / (double)solver.max_literals);
 	 printf("---------------------------------------------------------------------------------------------------\n");
 }
 
 
-static Solver* solver;
-// Terminate by notifying the solver and back out gracefully. This is mainly to have a test-case
-// for this feature of the Solver as it may take longer than an immediate call to '_exit()'.
-static void SIGINT_interrupt(int signum) { solver->interrupt(); }
+// Reads the comma separated minutils of '-minutil-sweep' into 'cuts', increasing and without
+// duplicates. Returns false if one of them is not a positive integer.
+static bool parseSweep(const char* str, vec<int>& cuts)
+{
+    while (*str){
+        char* end;
+        long  x = strtol(str, &end, 10);
+        if (end == str || x < 1 || x > INT32_MAX || (*end != ',' && *end != '\0')) return false;
+        cuts.push((int)x);
+        str = *end ? end + 1 : end;
+    }
+    sort(cuts);
+    int j = 0;
+    for (int i = 0; i < cuts.size(); i++)
+        if (j == 0 || cuts[i] != cuts[j-1]) cuts[j++] = cuts[i];
+    cuts.shrink(cuts.size() - j);
+    return cuts.size() > 0;
+}
+
+
+// Writes the statistics of the run to 'file' as JSON: the wall time of each phase, of each thread
+// (with how long it was left idle at the end) and of each guiding path, and whether the run was
+// interrupted before mining them all. Returns false on failure.
+static bool writeStatsJson(const char* file, const char* input, Cooperation& coop, double parse, double prep, double wall, bool complete)
+{
+    FILE* f = fopen(file, "w");
+    if (f == NULL) return false;
+    fprintf(f, "{\n  \"input\": \"");
+    for (const char* c = input; *c; c++)
+        if (*c == '"' || *c == '\\') fprintf(f, "\\%c", *c);
+        else if ((unsigned char)*c >= 32) fputc(*c, f);
+    fprintf(f, "\",\n  \"complete\": %s, \"minutil\": %d, \"closed\": %d, \"threads\": %d, \"items\": %d, \"transactions\": %d, \"paths\": %d,\n",
+            complete ? "true" : "false", coop.min_supp, (int)coop.enum_clos, coop.nbThreads, coop.nbItems, coop.list_transactions.size(), coop.VecGuiding.size());
+    fprintf(f, "  \"wall\": %.6f, \"parse\": %.6f, \"prep\": %.6f, \"mine\": %.6f, \"rss_mb\": %.1f,\n",
+            wall, parse, prep, coop.mineTime, memUsedPeak());
+
+    fprintf(f, "  \"thread_stats\": [");
+    for (int t = 0; t < coop.nbThreads; t++){
+        Solver& S = coop.solvers[t];
+        fprintf(f, "%s\n    {\"thread\": %d, \"wall\": %.6f, \"encode\": %.6f, \"search\": %.6f, \"idle\": %.6f, \"paths\": %d,"
+                " \"patterns\": %" PRIu64 ", \"propagations\": %" PRIu64 ", \"conflicts\": %" PRIu64 ", \"decisions\": %" PRIu64 "}",
+                t == 0 ? "" : ",", t, S.solveTime, S.encodeTime, S.solveTime - S.encodeTime, coop.mineTime - S.solveTime,
+                S.pathStats.size(), S.nbModels, S.propagations, S.conflicts, S.decisions);
+    }
+    fprintf(f, "\n  ],\n  \"path_stats\": [");
+    bool first = true;
+    for (int t = 0; t < coop.nbThreads; t++)
+        for (int i = 0; i < coop.solvers[t].pathStats.size(); i++){
+            const Solver::PathStat& P = coop.solvers[t].pathStats[i];
+            fprintf(f, "%s\n    {\"path\": %d, \"item\": %d, \"thread\": %d, \"transactions\": %d, \"rows\": %d, \"items\": %d,"
+                    " \"clauses\": %d, \"small\": %d, \"patterns\": %" PRIu64 ", \"encode\": %.6f, \"search\": %.6f}",
+                    first ? "" : ",", P.path, P.item, t, P.trans, P.rows, P.items, P.clauses, (int)P.small, P.patterns, P.encode, P.search);
+            first = false;
+        }
+    fprintf(f, "\n  ]\n}\n");
+    return fclose(f) == 0;
+}
+
+
+// Replaces the previous results by the new ones (written aside), 'itemsets' in all, and saves the
+// state of the run.
+static void finishIncrement(bool incr, const char* newPath, const char* resName, Increment& state, const char* statePath, uint64_t itemsets)
+{
+    if (incr && rename(newPath, resName) != 0)
+        fprintf(stderr, "ERROR! Could not replace the previous results %s by %s\n", resName, newPath), exit(1);
+    state.wrote(resName, itemsets);
+    if (!state.save(statePath))
+        fprintf(stderr, "WARNING! Could not write the state of the run to %s\n", statePath);
+}
+
+
+static Solver*      solver;
+static Cooperation* cooperation;
+static bool         interrupted = false;
+// Terminate by notifying the solvers and back out gracefully: the threads leave their guiding paths
+// unfinished, and the finished ones are checkpointed (see '-checkpoint').
+static void SIGINT_interrupt(int signum) {
+    interrupted = true;
+    for (int t = 0; t < cooperation->nbThreads; t++)
+        cooperation->solvers[t].interrupt();
+    if (cooperation->out != NULL) cooperation->out->interrupt(); }
 
 // Note that '_exit()' rather than 'exit()' has to be used. The reason is that 'exit()' calls
 // destructors and may cause deadlocks if a malloc/free function happens to be running (these
@@ -84,7 +168,7 @@ static void SIGINT_exit(int signum) {
 int main(int argc, char** argv)
 {
     try {
-        setUsageHelp("USAGE: %s [options] <input-file> <result-output-file>\n\n  where input may be either in plain or gzipped DIMACS.\n");
+        setUsageHelp("USAGE: %s [options] <input-file> <result-output-file>\n\n  where input may be either in plain or gzipped DIMACS or SPMF (items:TU:utilities) format.\n");
         // printf("This is MiniSat 2.0 beta\n");
         
 #if defined(__linux__)
@@ -99,22 +183,58 @@ int main(int argc, char** argv)
         IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", INT32_MAX, IntRange(0, INT32_MAX));
 
 	IntOption    ncores ("MAIN", "ncores","# threads.\n", 1,  IntRange(0, INT32_MAX));//IntRange(1, omp_get_num_procs()));
-	IntOption    limitEx("MAIN", "limitEx","Limit size clause exchange.\n", 10, IntRange(0, INT32_MAX));
-	IntOption    ctrl   ("MAIN", "ctrl","Dynamic control clause sharing with 2 modes.\n", 0, IntRange(0, 2));
 	IntOption    min_supp    ("MAIN", "minutil","# ....\n", 10,  IntRange(1, 100000000));//IntRange(1, omp_get_num_procs()));
 	IntOption    enum_clos ("MAIN", "closed","# ....\n", 1,  IntRange(0, 1));//IntRange(1, omp_get_num_procs()));
+	IntOption    split  ("MAIN", "split","Split heavy guiding paths over up to this many second items (0=off).\n", 4,  IntRange(0, INT32_MAX));
+	BoolOption   bitset ("MAIN", "bitset","Check support and closure on tidsets instead of clauses.\n", false);
+	IntOption    small  ("MAIN", "small-path","Mine the guiding paths of at most this many distinct transactions by a direct search, without encoding them (0=off).\n", 16,  IntRange(0, 64));
+	IntOption    topk   ("MAIN", "topk","Keep the k itemsets of highest utility, raising minutil as they are found (0=off).\n", 0,  IntRange(0, INT32_MAX));
+	BoolOption   count  ("MAIN", "count","Only count the itemsets, with a histogram of their utility (no output, no top-k).\n", false);
+	BoolOption   binary ("MAIN", "binary","Write the itemsets to the result file in binary form.\n", false);
+	BoolOption   cache  ("MAIN", "cache","Keep a binary copy <input>.bin of the database and load it while it is up to date.\n", false);
+	BoolOption   stats  ("MAIN", "stats","Print the times, counts and peak memory of the run as one 'STATS key=value ...' line.\n", false);
+	StringOption statsJson("MAIN", "stats-json","Write the wall times of the phases, threads and guiding paths to this JSON file.\n");
+	BoolOption   incremental("MAIN", "incremental","Keep the state of the run in <result-output-file>.state and, while the database only grows,\n"
+				"mine only the itemsets of its new transactions, the others being kept from the previous results.\n", false);
+	StringOption checkpoint("MAIN", "checkpoint","Record the guiding paths in this file as they are finished, for '-resume'.\n");
+	BoolOption   resume ("MAIN", "resume","Skip the guiding paths of the '-checkpoint' file finished by an interrupted run of the same\n"
+				"settings, keeping their itemsets of the result file (without the file: mine all).\n", false);
+	BoolOption   pin    ("MAIN", "pin","Bind each thread to one of the CPUs the process may run on, NUMA node by node.\n", false);
+	BoolOption   numa   ("MAIN", "numa","Bind the threads (-pin) and give those of each NUMA node their own copy of the database.\n", false);
+	StringOption sweep  ("MAIN", "minutil-sweep","Mine the itemsets of each of these comma separated minutils in one run (replaces -minutil, no top-k).\n");
+#ifdef USE_MPI
+        distInit(&argc, &argv);
+#endif
         parseOptions(argc, argv, true);
+#ifdef USE_MPI
+        // the other processes only report through process 0, and write to their own result files
+        if (distRank() > 0 && freopen("/dev/null", "w", stdout) == NULL)
+            fprintf(stderr, "ERROR! Could not silence process %d\n", distRank()), exit(1);
+#endif
 
-	double initial_time = cpuTime();
+	double wall_start   = omp_get_wtime();
 
 		
 	int nbThreads   = ncores;
-	int limitExport = limitEx;	
-	Cooperation coop(nbThreads, limitExport);
+	Cooperation coop(nbThreads);
+	solver      = &coop.solvers[0];
+	cooperation = &coop;
 	
-	coop.ctrl = ctrl;
 	coop.min_supp  = min_supp;
 	coop.enum_clos = enum_clos;
+	coop.splitWidth = split;
+	coop.bitset = bitset;
+	coop.smallPath = small;
+	coop.countOnly = count;
+	coop.pin  = pin || numa;
+	coop.numa = numa;
+	coop.topk = count ? 0 : (int)topk;
+	if (sweep != NULL){
+	  if (!parseSweep(sweep, coop.sweep))
+	    fprintf(stderr, "ERROR! Invalid minutil sweep: %s\n", (const char*)sweep), exit(1);
+	  coop.min_supp = coop.sweep[0];
+	  coop.topk     = 0;
+	}
 	
 
 	for(int t = 0; t < nbThreads; t++){
@@ -134,6 +254,7 @@ int main(int argc, char** argv)
         // Use signal handlers that forcibly quit until the solver will be able to respond to
         // interrupts:
         signal(SIGINT, SIGINT_exit);
+        signal(SIGTERM,SIGINT_exit);
         signal(SIGXCPU,SIGINT_exit);
 
         // Set limit on CPU-time:
@@ -160,11 +281,6 @@ int main(int argc, char** argv)
         if (argc == 1)
             printf("Reading from standard input... Use '--help' for help.\n");
         
-        gzFile in = (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb");
-        if (in == NULL)
-            printf("ERROR! Could not open file: %s\n", argc == 1 ? "<stdin>" : argv[1]), exit(1);
-	
-	
 
         if (coop.solvers[0].verbosity > 0){
             printf(" ===============================================[ Problem Statistics ]==================================================\n");
@@ -180,10 +296,97 @@ int main(int argc, char** argv)
 	printf("<> closed? : %d \n\n", coop.enum_clos);
 	
 	omp_set_num_threads(nbThreads);
-	parse_DIMACS(in, &coop);
+	if (!load_database(argc == 1 ? NULL : argv[1], &coop, cache))
+	  printf("ERROR! Could not open file: %s\n", argc == 1 ? "<stdin>" : argv[1]), exit(1);
+	double wall_parsed  = omp_get_wtime();
+
+	// incremental run: the previous results hold the itemsets of the transactions mined then
+	Increment   prev, next;
+	bool        incr = false;
+	int         prevKept = 0;                   // itemsets kept from the previous results
+	char        statePath[4096], newPath[4096];
+	if (incremental){
+	  bool alone = true;
+#ifdef USE_MPI
+	  alone = distSize() == 1;
+#endif
+	  if (argc < 3 || count || coop.topk > 0 || coop.sweep.size() > 0 || !alone)
+	    fprintf(stderr, "ERROR! -incremental needs a result file, one process and neither -count, -topk nor -minutil-sweep\n"), exit(1);
+	  if (snprintf(statePath, sizeof(statePath), "%s.state", argv[2]) >= (int)sizeof(statePath)
+	      || snprintf(newPath, sizeof(newPath), "%s.new", argv[2]) >= (int)sizeof(newPath))
+	    fprintf(stderr, "ERROR! Result file name too long: %s\n", argv[2]), exit(1);
+	  incr = prev.load(statePath) && prev.follows(coop);
+	  if (incr && !prev.results(argv[2])){
+	    incr = false;
+	    printf("<> incremental : %s is not the result file of the previous run, mining all of it\n", argv[2]);
+	  }else if (incr){
+	    coop.firstNew = prev.transactions;
+	    prev.index(coop);
+	    printf("<> incremental : %d new transactions\n", coop.list_transactions.size() - prev.transactions);
+	  }else
+	    printf("<> incremental : no previous run of this database, mining all of it\n");
+	  next.record(coop);
+	}
+	coop.buildGuidingPaths();
+	double wall_paths   = omp_get_wtime();
+
+	// checkpointed run: the guiding paths finished by an interrupted run of it are skipped
+	Checkpoint  ckpt;
+	if (checkpoint != NULL){
+	  bool alone = true;
+#ifdef USE_MPI
+	  alone = distSize() == 1;
+#endif
+	  if (count || coop.topk > 0 || coop.sweep.size() > 0 || incremental || !alone)
+	    fprintf(stderr, "ERROR! -checkpoint needs one process and neither -count, -topk, -minutil-sweep nor -incremental\n"), exit(1);
+	  if (resume && access(checkpoint, F_OK) == 0){
+	    if (!ckpt.load(checkpoint, coop))
+	      fprintf(stderr, "ERROR! %s is not a checkpoint of this run (database, -minutil, -closed, -split or -ncores differ)\n", (const char*)checkpoint), exit(1);
+	    printf("<> resume : %d of %d guiding paths done, %" PRIu64 " itemsets\n", ckpt.paths, coop.VecGuiding.size(), ckpt.patterns);
+	  }
+	  coop.checkpoint = &ckpt;
+	}else if (resume)
+	  fprintf(stderr, "ERROR! -resume needs -checkpoint\n"), exit(1);
 		
-		gzclose(in);
-        FILE* res = (argc >= 3) ? fopen(argv[2], "wb") : NULL;
+        // the itemsets go to the result file, or to the standard output at verbosity 3
+        const char* resName = (argc >= 3) ? argv[2] : NULL;
+#ifdef USE_MPI
+        char resRank[4096];
+        if (resName != NULL && distSize() > 1){
+            if (snprintf(resRank, sizeof(resRank), "%s.%d", resName, distRank()) >= (int)sizeof(resRank))
+                fprintf(stderr, "ERROR! Result file name too long: %s\n", resName), exit(1);
+            resName = resRank; }
+#endif
+        if (ckpt.paths > 0 && resName != NULL){
+            // only the itemsets of the finished paths are kept (written aside, then swapped in)
+            if (snprintf(newPath, sizeof(newPath), "%s.new", resName) >= (int)sizeof(newPath))
+                fprintf(stderr, "ERROR! Result file name too long: %s\n", resName), exit(1);
+            FILE* f = fopen(newPath, "wb");
+            if (f == NULL)
+                fprintf(stderr, "ERROR! Could not open file: %s\n", newPath), exit(1);
+            ItemsetWriter kept(f, binary, "", 1, coop.nbItems);
+            int n = ckpt.keep(resName, &kept, coop);
+            kept.close();
+            if (n < 0 || rename(newPath, resName) != 0)
+                fprintf(stderr, "ERROR! Could not take up the previous results: %s\n", resName), exit(1);
+            printf("<> resume : %d itemsets kept from the previous results\n", n);
+        }
+        FILE* res = (resName != NULL) ? fopen(incr ? newPath : resName, ckpt.paths > 0 ? "ab" : "wb") : NULL;
+        if (resName != NULL && res == NULL)
+            fprintf(stderr, "ERROR! Could not open file: %s\n", resName), exit(1);
+        if (!count && (res != NULL || verb >= 3))
+            coop.out = new ItemsetWriter(res != NULL ? res : stdout, res != NULL && binary, res != NULL ? "" : "->  ", nbThreads, coop.nbItems);
+        if (incr){
+            prevKept = prev.keep(resName, coop.out);
+            if (prevKept < 0)
+                fprintf(stderr, "ERROR! Could not read the previous results: %s\n", resName), exit(1);
+            printf("<> incremental : %d itemsets kept from the previous run\n", prevKept);
+        }
+        if (coop.checkpoint != NULL){
+            if (!ckpt.open(checkpoint, coop))
+                fprintf(stderr, "ERROR! Could not write the checkpoint: %s\n", (const char*)checkpoint), exit(1);
+            if (coop.out != NULL) coop.out->recordTo(&ckpt);
+        }
         
 	/* if (coop.solvers[0].verbosity > 0){
 	  printf("|  Number of cores:      %12d                                                                                   |\n", coop.nbThreads); 
@@ -192,15 +395,11 @@ int main(int argc, char** argv)
 
 	  }*/
         
-        double parsed_time = cpuTime();
-        /*if (coop.solvers[0].verbosity > 0){
-            printf("|  Parse time:           %12.2f s                                                                                 |\n", parsed_time - initial_time);
-            printf("|                                                                                                                       |\n"); }*/
- 
 
         // Change to signal-handlers that will only notify the solver and allow it to terminate
         // voluntarily:
         signal(SIGINT, SIGINT_interrupt);
+        signal(SIGTERM,SIGINT_interrupt);
         signal(SIGXCPU,SIGINT_interrupt);
        
  
@@ -214,13 +413,18 @@ int main(int argc, char** argv)
 
 
 	if (!coop.solvers[0].simplify()){
-	  if (res != NULL) fprintf(res, "UNSAT\n"), fclose(res);
+	  if (coop.out != NULL) coop.out->close();
+	  if (incremental) finishIncrement(incr, newPath, resName, next, statePath, prevKept);
 	  if (coop.solvers[0].verbosity > 0){
 	    // printf("========================================================================================================================\n");
 	    // printf("Solved by unit propagation\n");
 	    printStats(coop.solvers[0]);
 	    printf("\n"); }
 	  printf("UNSATISFIABLE\n");
+#ifdef USE_MPI
+	  distFinish();
+	  exit(0);
+#endif
 	  exit(20);
         }
         
@@ -229,20 +433,21 @@ int main(int argc, char** argv)
 	
 		
 	int winner = 0;
-	lbool ret;
 	lbool result;
 	
 	// launch threads in Parallel 	
 
 	
-#pragma omp parallel
-	{
-	  int t = omp_get_thread_num();
-	  coop.start = true;
-	  coop.solvers[t].EncodeDB(&coop);
-	  ret = coop.solvers[t].solve_(&coop);
-	  //printf("thread id %d has finished \n", t);
+	coop.LaunchSolvers();
+	ckpt.close();
+	if (incremental && !interrupted){
+	  uint64_t n = prevKept;
+	  for(int t = 0; t < coop.nThreads(); t++)
+	    n += coop.solvers[t].nbModels;
+	  finishIncrement(incr, newPath, resName, next, statePath, n);
 	}
+	if (interrupted)
+	  printf("*** INTERRUPTED ***%s\n", checkpoint != NULL ? " (the finished guiding paths are checkpointed, see -resume)" : "");
 	
 	// select winner threads with respect to deterministic mode 
 	for(int t = 0; t < coop.nThreads(); t++)
@@ -252,7 +457,7 @@ int main(int argc, char** argv)
 	    break;
 	  }
 
-	int cpt = 0;
+	uint64_t cpt = ckpt.patterns;
 	// each worker print its models
 	//printf("-----------------------------------------------\n");
 	//printf("thread | nb models          | nb conflicts    |\n");
@@ -265,40 +470,96 @@ int main(int argc, char** argv)
 	  //printf("%15d  |  %d | %15d \n",  coop.solvers[t].nbModels, (int)coop.solvers[t].conflicts,  nbcls);
 	  //coop.solvers[t].printModels();
 	printf("---------------------------------------------------------------------------------------------------\n");
-         printf("                               |-- #patterns  : %15d   \n",coop.solvers[t].nbModels);
+         printf("                               |-- #patterns  : %15" PRIu64 "   \n",coop.solvers[t].nbModels);
 	 printf("  SAT's Output                 |-- #conflicts  : %d       \n", (int)coop.solvers[t].conflicts);
 	 printf("                               |-- #clauses  : %15d   \n", nbcls);
+	 printf("                               |-- #variables  : %15d   \n", coop.solvers[t].nVars());
+	 int nbSmall = 0;
+	 for(int i = 0; i < coop.solvers[t].pathStats.size(); i++)
+	   nbSmall += coop.solvers[t].pathStats[i].small;
+	 printf("                               |-- wall time  : %12.3f s (%d paths, %d small, encoding %.3f s, idle %.3f s)\n",
+		coop.solvers[t].solveTime, coop.solvers[t].pathStats.size(), nbSmall, coop.solvers[t].encodeTime, coop.mineTime - coop.solvers[t].solveTime);
 	printf("---------------------------------------------------------------------------------------------------\n");
 	}
+	if (ckpt.paths > 0){
+	  printf("  Resumed                      |-- #patterns  : %15" PRIu64 "   (%d guiding paths of the previous runs)\n", ckpt.patterns, ckpt.paths);
+	  printf("---------------------------------------------------------------------------------------------------\n");
+	}
+	printf("  Wall time                    |-- parse  : %12.3f s \n", wall_parsed - wall_start);
+	printf("                               |-- guiding paths  : %12.3f s \n", wall_paths - wall_parsed);
+	printf("                               |-- mining  : %12.3f s \n", coop.mineTime);
+	printf("---------------------------------------------------------------------------------------------------\n");
 
 	
 
+	// count-only mode: number of itemsets reaching minutil, 2.minutil, 4.minutil...
+	if (coop.countOnly){
+	  uint64_t left = cpt;
+	  printf("  Utility distribution          |-- #patterns  : %15" PRIu64 "   \n", cpt);
+	  for(int b = 0; b < 32 && left > 0; b++){
+	    printf("                               |-- utility >= %12" PRId64 " : %15" PRIu64 "   \n", (int64_t)coop.min_supp << b, left);
+	    for(int t = 0; t < coop.nThreads(); t++)
+	      left -= coop.solvers[t].utilHist[b];
+	  }
+	  printf("---------------------------------------------------------------------------------------------------\n");
+	}
+
+	// sweep mode: number of itemsets of each minutil
+	if (coop.sweep.size() > 0){
+	  uint64_t left = cpt;
+	  printf("  Minutil sweep                 |-- #patterns  : %15" PRIu64 "   \n", cpt);
+	  for(int b = 0; b < coop.sweep.size(); b++){
+	    printf("                               |-- minutil >= %12d : %15" PRIu64 "   \n", coop.sweep[b], left);
+	    for(int t = 0; t < coop.nThreads(); t++)
+	      left -= coop.solvers[t].sweepHist[b];
+	  }
+	  printf("---------------------------------------------------------------------------------------------------\n");
+	}
+
+	if (coop.topk > 0){
+	  printf("                               |-- #top-k  : %15d   \n", coop.topSets.size());
+	  printf("                               |-- minutil  : %15d   \n", coop.min_supp);
+	  printf("---------------------------------------------------------------------------------------------------\n");
+	}
+
 	//coop.printStats(coop.solvers[winner].threadId);
 	printStats(coop.solvers[winner]);
+
+	if (statsJson != NULL && !writeStatsJson(statsJson, argc == 1 ? "<stdin>" : argv[1], coop, wall_parsed - wall_start, wall_paths - wall_parsed, omp_get_wtime() - wall_start, !interrupted))
+	  fprintf(stderr, "WARNING! Could not write the statistics to %s\n", (const char*)statsJson);
+
+	// one line for scripts, see 'bench.sh' (encode and search: summed over the threads; minutil: the one
+	// mined, raised by -topk or the least of -minutil-sweep; complete=0: interrupted, partial counts)
+	if (stats){
+	  double   encode = 0, search = 0;
+	  uint64_t props = 0, confl = 0;
+	  for(int t = 0; t < coop.nThreads(); t++){
+	    encode += coop.solvers[t].encodeTime;
+	    search += coop.solvers[t].solveTime - coop.solvers[t].encodeTime;
+	    props  += coop.solvers[t].propagations;
+	    confl  += coop.solvers[t].conflicts;
+	  }
+	  printf("STATS complete=%d minutil=%d closed=%d threads=%d wall=%.3f parse=%.3f prep=%.3f encode=%.3f search=%.3f"
+		 " patterns=%" PRIu64 " propagations=%" PRIu64 " conflicts=%" PRIu64 " rss_mb=%.1f\n",
+		 (int)!interrupted, coop.min_supp, (int)enum_clos, nbThreads, omp_get_wtime() - wall_start, wall_parsed - wall_start,
+		 wall_paths - wall_parsed, encode, search, cpt, props, confl, memUsedPeak());
+	}
 	
 	//if (coop.solvers[winner].verbosity > 0){
 	  //printStats(coop.solvers[winner]);
 	// printf("\n");
 	//}
         //printf(result == l_True ? "SATISFIABLE\n" : result == l_False ? "UNSATISFIABLE\n" : "INDETERMINATE\n");
-        if (res != NULL){
-            if (result == l_True){
-	      fprintf(res, "SAT\n");
-                for (int i = 0; i < coop.solvers[winner].nVars(); i++)
-                    if (coop.solvers[winner].model[i] != l_Undef)
-                        fprintf(res, "%s%s%d", (i==0)?"":" ", (coop.solvers[winner].model[i]==l_True)?"":"-", i+1);
-                fprintf(res, " 0\n");
-            }else if (result == l_False)
-                fprintf(res, "UNSAT\n");
-            else
-                fprintf(res, "INDET\n");
-            fclose(res);
-        }
-        
+        // an interrupted run exits with 1, as before the mining could be resumed; a rank of an MPI run
+        // otherwise exits with 0, which 'mpirun' takes for success (10 and 20 for failures)
+#ifdef USE_MPI
+        distFinish();
+        exit(interrupted ? 1 : 0);
+#endif
 #ifdef NDEBUG
-        exit(result == l_True ? 10 : result == l_False ? 20 : 0);     // (faster than "return", which will invoke the destructor for 'Solver')
+        exit(interrupted ? 1 : result == l_True ? 10 : result == l_False ? 20 : 0);     // (faster than "return", which will invoke the destructor for 'Solver')
 #else
-        return (result == l_True ? 10 : result == l_False ? 20 : 0);
+        return (interrupted ? 1 : result == l_True ? 10 : result == l_False ? 20 : 0);
 #endif
     } catch (OutOfMemoryException&){
         printf("===============================================================================\n");
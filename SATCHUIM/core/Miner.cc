@@ -0,0 +1,62 @@
+#include "core/Dimacs.h"
+#include "core/Miner.h"
+
+using namespace Minisat;
+
+
+Miner::Miner(int threads) :
+    loadThreads(threads > 0 ? threads : 1), splitWidth(4), bitset(false), smallPath(16)
+{
+    db = new Cooperation(1);
+}
+
+
+Miner::~Miner()
+{
+    delete db;
+}
+
+
+bool Miner::load(const char* path, bool cache)
+{
+    delete db;
+    db = new Cooperation(1);         // never mined: one solver, the threads only parse
+    return load_database(path, db, cache, loadThreads);
+}
+
+
+int Miner::nbItems        () const { return db->nbItems; }
+int Miner::nbTransactions () const { return db->list_transactions.size(); }
+
+
+// Mines the itemsets of utility >= 'minutil' (closed ones only if 'closed') with 'threads' threads,
+// calling 'cb' on each. Returns their number. As on the command line, 'minutil' is at least 1 and
+// 'threads' at least 1.
+uint64_t Miner::mine(int minutil, bool closed, int threads, ItemsetCallback cb, void* data)
+{
+    if (minutil < 1) minutil = 1;
+    if (threads < 1) threads = 1;
+
+    Cooperation coop(threads);
+    coop.min_supp     = minutil;
+    coop.enum_clos    = closed;
+    coop.splitWidth   = splitWidth;
+    coop.bitset       = bitset;
+    coop.smallPath    = smallPath;
+    coop.callback     = cb;
+    coop.callbackData = data;
+    for (int t = 0; t < threads; t++){
+        coop.solvers[t].threadId  = t;
+        coop.solvers[t].verbosity = 0; }
+
+    coop.copyDatabase(*db);
+    coop.buildGuidingPaths();
+    if (!coop.solvers[0].simplify())
+        return 0;
+    coop.LaunchSolvers();
+
+    uint64_t n = 0;
+    for (int t = 0; t < threads; t++)
+        n += coop.solvers[t].nbModels;
+    return n;
+}
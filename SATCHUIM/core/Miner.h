@@ -0,0 +1,50 @@
+#ifndef Minisat_Miner_h
+#define Minisat_Miner_h
+
+#include "mtl/IntTypes.h"
+#include "core/Output.h"
+
+namespace Minisat {
+
+class Cooperation;
+
+/*=================================================================================================
+ Miner Class : ->  [class]
+Description:
+	Library entry point: loads a database once, then mines it for any number of queries, each
+	itemset being handed to a callback. Every query works on its own copy of the loaded tables
+	(their pruning depends on minutil) and on its own solvers, but the threads are those of the
+	OpenMP runtime, which keeps them from one query to the next.
+
+	    Miner m(8);
+	    if (m.load("chess.txt"))
+	        for (int u = 800000; u >= 600000; u -= 100000)
+	            printf("%" PRIu64 "\n", m.mine(u, true, 8, found, &results));
+
+	The queries of one Miner are run one at a time.
+=================================================================================================*/
+
+  class Miner {
+
+    Cooperation*   db;                      // the database as loaded, never pruned
+    int            loadThreads;
+
+  public:
+    int            splitWidth;              // see the options of the same name of the solver
+    bool           bitset;
+    int            smallPath;
+
+    Miner(int threads = 1);
+   ~Miner();
+
+    bool           load     (const char* path, bool cache = false);    // false: can't be read
+    uint64_t       mine     (int minutil, bool closed, int threads, ItemsetCallback cb, void* data = NULL);
+
+    int            nbItems        () const;
+    int            nbTransactions () const;
+  };
+
+//=================================================================================================
+}
+
+#endif
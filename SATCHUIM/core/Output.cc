@@ -0,0 +1,257 @@
+#include <string.h>
+#include <unistd.h>
+
+#include "core/Checkpoint.h"
+#include "core/Output.h"
+#include "utils/ParseUtils.h"
+
+using namespace Minisat;
+
+static const char outMagic[8] = { 'S', 'C', 'H', 'U', 'I', 'M', 'P', '1' };
+
+
+// The ring counters are only written by one side each, and read by the other:
+static inline int atomicRead(int& x)
+{
+    int v;
+#pragma omp atomic read seq_cst
+    v = x;
+    return v;
+}
+
+static inline void atomicIncr(int& x)
+{
+#pragma omp atomic update seq_cst
+    x++;
+}
+
+
+static inline char* putInt(char* p, int x)
+{
+    char     tmp[12];
+    int      n = 0;
+    unsigned v = x;
+    if (x < 0) *p++ = '-', v = -(unsigned)x;
+    do tmp[n++] = '0' + v % 10; while ((v /= 10) != 0);
+    while (n > 0) *p++ = tmp[--n];
+    return p;
+}
+
+
+ItemsetWriter::ItemsetWriter(FILE* f, bool bin, const char* pre, int n, int maxItems) :
+    file(f), binary(bin), prefix(pre), nbThreads(n), done(0), stopped(0), checkpoint(NULL)
+{
+    // the largest record must fit in a buffer
+    bufSize = 12 * (maxItems + 3) + strlen(prefix) + 32;
+    if (bufSize < (1 << 20)) bufSize = 1 << 20;
+
+    rings = new Ring[nbThreads];
+    for (int t = 0; t < nbThreads; t++){
+        for (int k = 0; k < nbBuffers; k++)
+            rings[t].data[k] = new char[bufSize], rings[t].len[k] = 0;
+        rings[t].filled = rings[t].written = rings[t].pos = 0;
+    }
+    running = 1;
+
+    // (not when appending to the results of an interrupted run)
+    if (binary && ftell(file) <= 0) fwrite(outMagic, 1, sizeof(outMagic), file);
+}
+
+
+ItemsetWriter::~ItemsetWriter()
+{
+    for (int t = 0; t < nbThreads; t++)
+        for (int k = 0; k < nbBuffers; k++)
+            delete [] rings[t].data[k];
+    delete [] rings;
+}
+
+
+// Hands the current buffer of thread 't' over and waits for the next one to be free.
+void ItemsetWriter::handOver(int t)
+{
+    Ring& r = rings[t];
+    r.len[r.filled % nbBuffers] = r.pos;
+    r.pos = 0;
+    atomicIncr(r.filled);
+    while (r.filled - atomicRead(r.written) >= nbBuffers){
+        if (atomicRead(running) && !atomicRead(stopped)) usleep(100);
+        else{
+#pragma omp critical(itemsetWriter)
+            drain();
+        }
+    }
+}
+
+
+// Writes out the buffers handed over so far. Returns false if there were none. (One thread at a
+// time: the writer thread, or those waiting for a buffer, see 'handOver()'.)
+bool ItemsetWriter::drain()
+{
+    bool any = false;
+    for (int t = 0; t < nbThreads; t++){
+        Ring& r = rings[t];
+        int   f = atomicRead(r.filled);
+        while (r.written < f){
+            int k = r.written % nbBuffers;
+            fwrite(r.data[k], 1, r.len[k], file);
+            if (r.paths[k].size() > 0){
+                fflush(file);
+                for (int i = 0; i < r.paths[k].size(); i++)
+                    checkpoint->record(r.paths[k][i], r.counts[k][i]);
+                r.paths[k].clear();
+                r.counts[k].clear();
+            }
+            atomicIncr(r.written);
+            any = true;
+        }
+    }
+    return any;
+}
+
+
+void ItemsetWriter::write(int t, const vec<int>& items, int util, int sup)
+{
+    Ring& r    = rings[t];
+    int   need = binary ? 4 * (items.size() + 3) : 12 * (items.size() + 3) + strlen(prefix) + 32;
+    if (r.pos + need > bufSize)
+        handOver(t);
+
+    char* beg = current(t) + r.pos;
+    char* p   = beg;
+    if (binary){
+        int head[3] = { items.size(), util, sup };
+        memcpy(p, head, sizeof(head)), p += sizeof(head);
+        for (int i = 0; i < items.size(); i++){
+            int x = items[i] + 1;
+            memcpy(p, &x, sizeof(x)), p += sizeof(x); }
+    }else{
+        for (const char* q = prefix; *q; q++) *p++ = *q;
+        for (int i = 0; i < items.size(); i++)
+            p = putInt(p, items[i] + 1), *p++ = ' ';
+        memcpy(p, "#UTIL: ", 7), p = putInt(p + 7, util);
+        memcpy(p, " #SUP: ", 7), p = putInt(p + 7, sup);
+        *p++ = '\n';
+    }
+    r.pos += p - beg;
+}
+
+
+void ItemsetWriter::writeNow(const vec<int>& items, int util, int sup)
+{
+    Ring& r = rings[0];
+    write(0, items, util, sup);
+    fwrite(current(0), 1, r.pos, file);
+    r.pos = 0;
+}
+
+
+// The path is recorded once its buffer is written out: the buffer is handed over early, once half
+// full, so that the paths are recorded soon but small ones do not each wait on the writer.
+void ItemsetWriter::pathDone(int t, int path, uint64_t n)
+{
+    Ring& r = rings[t];
+    int   k = r.filled % nbBuffers;
+    r.paths [k].push(path);
+    r.counts[k].push(n);
+    if (2 * r.pos >= bufSize)
+        handOver(t);
+}
+
+
+void ItemsetWriter::finish(int t)
+{
+    if (pending(t))
+        handOver(t);
+    atomicIncr(done);
+}
+
+
+void ItemsetWriter::run()
+{
+    for (;;){
+        int  d = atomicRead(done);
+        bool any;
+#pragma omp critical(itemsetWriter)
+        any = drain();
+        if (any) continue;
+        if (d == nbThreads) break;
+        usleep(500);
+    }
+#pragma omp atomic write seq_cst
+    running = 0;
+}
+
+
+void ItemsetWriter::noWriter()
+{
+#pragma omp atomic write seq_cst
+    running = 0;
+}
+
+
+void ItemsetWriter::close()
+{
+    running = 0;
+    for (int t = 0; t < nbThreads; t++)
+        if (pending(t))
+            handOver(t);
+    drain();
+    if (file == stdout) fflush(file);
+    else                fclose(file);
+}
+
+
+ItemsetReader::~ItemsetReader()
+{
+    delete in;
+    if (file != NULL) gzclose(file);
+}
+
+
+bool ItemsetReader::open(const char* name)
+{
+    char magic[sizeof(outMagic)];
+    file = gzopen(name, "rb");
+    if (file == NULL) return false;
+    binary = gzread(file, magic, sizeof(magic)) == (int)sizeof(magic) && memcmp(magic, outMagic, sizeof(magic)) == 0;
+    if (!binary){
+        gzrewind(file);
+        in = new StreamBuffer(file); }
+    return true;
+}
+
+
+bool ItemsetReader::next(vec<int>& items, int& util, int& sup)
+{
+    items.clear();
+    if (binary){
+        int head[3];
+        if (gzread(file, head, sizeof(head)) != (int)sizeof(head) || head[0] < 0) return false;
+        items.growTo(head[0]);
+        if (head[0] > 0 && gzread(file, &items[0], head[0] * sizeof(int)) != (int)(head[0] * sizeof(int))) return false;
+        for (int i = 0; i < items.size(); i++) items[i]--;
+        util = head[1], sup = head[2];
+        return true;
+    }
+
+    StreamBuffer& b = *in;
+    skipWhitespace(b);
+    if (isEof(b)) return false;
+    while (*b != '#' && !isEof(b)){
+        items.push(parseInt(b) - 1);
+        skipBlanks(b); }
+    // a line cut short (by an interrupted run) ends the file
+    if (!eagerMatch(b, "#UTIL:")) return false;
+    skipBlanks(b);
+    if (*b < '0' || *b > '9') return false;
+    util = parseInt(b);
+    skipBlanks(b);
+    if (!eagerMatch(b, "#SUP:")) return false;
+    skipBlanks(b);
+    if (*b < '0' || *b > '9') return false;
+    sup = parseInt(b);
+    if (*b != '\n' && *b != '\r') return false;
+    skipLine(b);
+    return true;
+}
@@ -0,0 +1,108 @@
+#ifndef Minisat_Output_h
+#define Minisat_Output_h
+
+#include <stdio.h>
+#include <zlib.h>
+
+#include "mtl/IntTypes.h"
+#include "mtl/Vec.h"
+
+namespace Minisat {
+
+class StreamBuffer;
+class Checkpoint;
+
+// Receives each itemset found by thread 'thread' (items numbered from 0), called from the threads
+// themselves:
+typedef void (*ItemsetCallback)(const int* items, int n, int util, int sup, int thread, void* data);
+
+/*=================================================================================================
+ ItemsetWriter Class : ->  [class]
+Description:
+	Output of the itemsets found by the threads. Each thread formats its itemsets into its own
+	buffers and hands the full ones over to a writer thread ('run()') through a ring without locks,
+	so that the threads never wait on the output nor interleave their lines.
+
+	Text format, one itemset per line (the SPMF format):  items #UTIL: utility #SUP: support
+	Binary format: the magic "SCHUIMP1", then per itemset the 'int32' values
+	                  n utility support item_1 .. item_n
+	The items are numbered from 1 as in the input.
+	Without a writer thread ('noWriter()'), or once interrupted, a thread waiting for a free buffer
+	writes the buffers out itself.
+	A thread marks the end of a guiding path in its ring ('pathDone()'): the path is recorded in
+	the checkpoint once its itemsets are in the file, when the buffer is handed over (half full at
+	the end of a path, full, or at the end of the run).
+=================================================================================================*/
+
+  class ItemsetWriter {
+
+    enum { nbBuffers = 4 };
+
+    struct Ring {
+      char*        data[nbBuffers];
+      int          len [nbBuffers];
+      vec<int>     paths[nbBuffers];        // guiding paths finished in each buffer ...
+      vec<uint64_t> counts[nbBuffers];      // ... and their itemsets
+      int          filled;                  // buffers handed over by the thread ...
+      int          written;                 // ... and those written out
+      int          pos;                     // write position in the current buffer
+      char         pad[64];                 // keeps the counters of two threads on separate lines
+    };
+
+    FILE*          file;
+    bool           binary;
+    const char*    prefix;                  // start of each text line
+    int            nbThreads;
+    int            bufSize;
+    Ring*          rings;
+    int            done;                    // threads that called 'finish()'
+    int            running;                 // the writer thread is (or will be) running
+    int            stopped;                 // the run is interrupted: the threads no longer wait on the writer
+    Checkpoint*    checkpoint;              // where the finished paths are recorded (NULL: none)
+
+    char*          current  (int t)         { Ring& r = rings[t]; return r.data[r.filled % nbBuffers]; }
+    bool           pending  (int t)         { Ring& r = rings[t]; return r.pos > 0 || r.paths[r.filled % nbBuffers].size() > 0; }
+    void           handOver (int t);
+    bool           drain    ();
+
+  public:
+    ItemsetWriter(FILE* f, bool bin, const char* pre, int n, int maxItems);
+   ~ItemsetWriter();
+
+    void           write    (int t, const vec<int>& items, int util, int sup);   // by thread 't'
+    void           writeNow (const vec<int>& items, int util, int sup);          // at once, before 'run()'
+    void           pathDone (int t, int path, uint64_t n);                       // by thread 't', after the itemsets of 'path'
+    void           finish   (int t);        // thread 't' has no more itemsets
+    void           recordTo (Checkpoint* c) { checkpoint = c; }
+    void           run      ();             // writer thread, until every thread has finished
+    void           noWriter ();             // no writer thread: the threads write their buffers out themselves
+    void           interrupt()              { stopped = 1; }                      // (from a signal handler)
+    void           close    ();             // writes out everything left (no thread running)
+  };
+
+
+/*=================================================================================================
+ ItemsetReader Class : ->  [class]
+Description:
+	Reads back the itemsets of a result file written by an ItemsetWriter, in either format (told
+	by the magic). The items are numbered from 0, as given to 'ItemsetWriter::write()'.
+=================================================================================================*/
+
+  class ItemsetReader {
+
+    gzFile         file;
+    bool           binary;
+    StreamBuffer*  in;                      // text format
+
+  public:
+    ItemsetReader() : file(NULL), binary(false), in(NULL) { }
+   ~ItemsetReader();
+
+    bool           open     (const char* name);                                 // false: can't be read
+    bool           next     (vec<int>& items, int& util, int& sup);             // false at the end
+  };
+
+//=================================================================================================
+}
+
+#endif
@@ -20,6 +20,7 @@
 
 #include <math.h>
 #include <omp.h>
+#include <string.h>
 #include "mtl/Sort.h"
 #include "core/Solver.h"
 #include "core/Cooperation.h"
@@ -80,6 +81,7 @@ verbosity        (0)
 // Statistics: (formerly in 'SolverStats')
 //
 , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0), dec_vars(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
+, encodeTime(0), solveTime(0), smallTime(0), pathStart(-1), dbTrans(NULL), dbUtil(NULL), dbAppear(NULL)
 
 , ok                 (true)
 , cla_inc            (1)
@@ -91,6 +93,18 @@ verbosity        (0)
 , order_heap         (VarOrderLt(activity))
 , progress_estimate  (0)
 , remove_satisfied   (true)
+, totalWeight        (0)
+, supportLeft        (0)
+, bhead              (0)
+, scanWeight         (INT32_MAX)
+, bitsetMode         (false)
+, searchMode         (modeAll)
+, tidWords           (0)
+, chead              (0)
+, closScan           (-1)
+, xhead              (0)
+, closConfl          (var_Undef)
+, min_supp           (0)
 
 // Resource constraints:
 //
@@ -122,7 +136,14 @@ Var Solver::newVar(bool sign, bool dvar)
     //activity .push(0);
     activity .push(rnd_init_act ? drand(random_seed, threadId) * 0.00001 : 0);
     seen     .push(0);
-    hu_wei   .push(0);
+    itemWeight.push(0);
+    transWeight.push(0);
+    counted  .push(0);
+    tidOffset.push(-1);
+    smallIndex.push(-1);
+    outCount .push(0);
+    mergedNext.push(var_Undef);
+    falseCount.push(0);
     useless  .push(0);
     isTrans  .push(0);
     seenItem .push(0);
@@ -217,7 +238,8 @@ bool Solver::satisfied(const Clause& c) const {
 
 // Revert to the state at given level (keeping all assignment at 'level' but not beyond).
 // Backtrack to level level 
-void Solver::cancelUntil(int level) {
+template<int M>
+void Solver::cancelUntil_(int level) {
     if (decisionLevel() > level){
         for (int c = trail.size()-1; c >= trail_lim[level]; c--){
             Var      x  = var(trail[c]);
@@ -225,28 +247,53 @@ void Solver::cancelUntil(int level) {
 	    if (phase_saving > 1 || (phase_saving == 1) && c > trail_lim.last())
 	      polarity[x] = sign(trail[c]);
 	    
-	    if(sign(trail[c]) && (x >= (nbItems + nbTrans)))
-	      totalWeight += hu_wei[x];
+	    if(c < bhead && sign(trail[c]))
+	      uncountUtility(x);
+	    if(M == modeBitset && x >= nbItems)
+	      bitSet(cover, x - nbItems);
+	    if(M == modeClosed && c < chead && sign(trail[c]) && x >= nbItems)
+	      uncountClosure(x);
 	    
 	    if(x < nbItems)
 	      insertVarOrder(x); }
         qhead = trail_lim[level];
+        if (bhead > qhead) bhead = qhead;
+        if (xhead > qhead) xhead = qhead;
+        if (chead > qhead) chead = qhead;
+        closScan = -1;
+        scanWeight = INT32_MAX;
         trail.shrink(trail.size() - trail_lim[level]);
         trail_lim.shrink(trail_lim.size() - level);
     } }
 
+void Solver::cancelUntil(int level) {
+    switch (searchMode){
+    case modeAll:    cancelUntil_<modeAll>   (level); break;
+    case modeClosed: cancelUntil_<modeClosed>(level); break;
+    default:         cancelUntil_<modeBitset>(level); }
+}
+
 // Backtrack to level 0 
 void Solver::cancelAll() {
   for (int c = trail.size()-1; c >= 0; c--){
     Var      x  = var(trail[c]);
     assigns [x] = l_Undef;
 
-    if(sign(trail[c]) && (x >= (nbItems + nbTrans)))
-      totalWeight += hu_wei[x];
+    if(c < bhead && sign(trail[c]))
+      uncountUtility(x);
+    if(bitsetMode && x >= nbItems)
+      bitSet(cover, x - nbItems);
+    if(c < chead && sign(trail[c]) && x >= nbItems)
+      uncountClosure(x);
     
     if(x < nbItems)
       insertVarOrder(x); }
   qhead = 0;
+  bhead = 0;
+  xhead = 0;
+  chead = 0;
+  closScan = -1;
+  scanWeight = INT32_MAX;
   int ind = 0;
   trail.shrink(trail.size() - ind);
   trail_lim.shrink(trail_lim.size() - ind);
@@ -294,6 +341,11 @@ Lit Solver::pickBranchLit()
  |      * If out_learnt.size() > 1 then 'out_learnt[1]' has the greatest decision level of the 
  |        rest of literals. There may be others from the same level though.
  |  
+ |  Note:
+ |    The conflicts CRef_Bound and CRef_Closure, and the literals of these reasons or CRef_Lazy, are
+ |    explained by 'explain()' in terms of items, but for the closure counters: the transactions of
+ |    the tidsets never enter a learnt clause, which could imply one true. The activity of the
+ |    variables is left alone, it orders the items of the path by support.
  |________________________________________________________________________________________________@*/
 void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
 {
@@ -304,19 +356,25 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
     //
     out_learnt.push();      // (leave room for the asserting literal)
     int index   = trail.size() - 1;
+    int lazy    = trail_lim[0];           // items before it are already visited by an explanation
 	
     do{
         assert(confl != CRef_Undef); // (otherwise should be UIP)
-        Clause& c = ca[confl];
-		
-        if (c.learnt())
-            claBumpActivity(c);
+        if (confl >= CRef_Lazy)
+            explain(p, confl, index + 1, lazy, analyze_reason);
+        else{
+            Clause& c = ca[confl];
+            if (c.learnt())
+                claBumpActivity(c);
+            analyze_reason.clear();
+            for (int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++)
+                analyze_reason.push(c[j]);
+        }
 		
-        for (int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++){
-            Lit q = c[j];
+        for (int j = 0; j < analyze_reason.size(); j++){
+            Lit q = analyze_reason[j];
 			
             if (!seen[var(q)] && level(var(q)) > 0){
-                varBumpActivity(var(q));
                 seen[var(q)] = 1;
                 if (level(var(q)) >= decisionLevel())
                     pathC++;
@@ -344,14 +402,14 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
             abstract_level |= abstractLevel(var(out_learnt[i])); // (maintain an abstraction of levels involved in conflict)
 		
         for (i = j = 1; i < out_learnt.size(); i++)
-            if (reason(var(out_learnt[i])) == CRef_Undef || !litRedundant(out_learnt[i], abstract_level))
+            if (reason(var(out_learnt[i])) >= CRef_Lazy || !litRedundant(out_learnt[i], abstract_level))
                 out_learnt[j++] = out_learnt[i];
         
     }else if (ccmin_mode == 1){
         for (i = j = 1; i < out_learnt.size(); i++){
             Var x = var(out_learnt[i]);
 			
-            if (reason(x) == CRef_Undef)
+            if (reason(x) >= CRef_Lazy)
                 out_learnt[j++] = out_learnt[i];
             else{
                 Clause& c = ca[reason(var(out_learnt[i]))];
@@ -389,6 +447,64 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
 }
 
 
+/*_________________________________________________________________________________________________
+ |
+ |  explain : (p : Lit) (from : CRef) (end : int) (lazy : int&) (out : vec<Lit>&)  ->  [void]
+ |
+ |  Description:
+ |    The false literals of a clause implying 'p' (or of a conflict if 'p' is lit_Undef) from the
+ |    reason 'from', with the literals assigned before the trail position 'end'. By default all the
+ |    items, those before 'lazy' excepted (visited already, moved up to 'end'). The closure of an
+ |    item q only needs q false and the transactions without q false: these transactions themselves
+ |    with the counters, the earliest true items leaving them out with tidsets. So does the bitset
+ |    conflict of the new transactions (see 'freshRows'), q undefined in 'closConfl'.
+ |________________________________________________________________________________________________@*/
+void Solver::explain(Lit p, CRef from, int end, int& lazy, vec<Lit>& out)
+{
+    out.clear();
+    Var q = p == lit_Undef ? closConfl : var(p);
+    if (from != CRef_Closure || (q == var_Undef && !bitsetMode)){
+        for (; lazy < end; lazy++)
+            if (var(trail[lazy]) < nbItems)
+                out.push(~trail[lazy]);
+        return; }
+
+    if (p == lit_Undef && q != var_Undef)
+        out.push(mkLit(q, false));
+
+    int R = pathRows.size();
+    if (!bitsetMode){
+        CsrRow<Lit> col = local_trans[q];
+        for (int i = 0, j = 0; i < R; i++)
+            if (j < col.size() && var(col[j]) == nbItems + i) j++;
+            else out.push(mkLit(nbItems + i, false));
+        return; }
+
+    // transactions to leave out, covered by the true items in trail order
+    vec<uint64_t>& need = analyze_need;
+    need.clear();
+    for (int w = 0; w < tidWords; w++)
+        need.push(q == var_Undef ? freshRows[w] : ~tidsets[tidOffset[q] + w]);
+    if (R & 63)
+        need.last() &= ((uint64_t)1 << (R & 63)) - 1;
+    for (int i = 0; i < end; i++){
+        Lit x = trail[i];
+        if (sign(x) || var(x) >= nbItems || tidOffset[var(x)] < 0)
+            continue;
+        const uint64_t* tids = &tidsets[tidOffset[var(x)]];
+        bool kills = false, left = false;
+        for (int w = 0; w < tidWords; w++){
+            kills |= (need[w] & ~tids[w]) != 0;
+            need[w] &= tids[w];
+            left  |= need[w] != 0; }
+        if (kills)
+            out.push(~x);
+        if (!left)
+            break;
+    }
+}
+
+
 // Check if 'p' can be removed. 'abstract_levels' is used to abort early if the algorithm is
 // visiting literals at levels that cannot be removed later.
 bool Solver::litRedundant(Lit p, uint32_t abstract_levels)
@@ -396,13 +512,13 @@ bool Solver::litRedundant(Lit p, uint32_t abstract_levels)
     analyze_stack.clear(); analyze_stack.push(p);
     int top = analyze_toclear.size();
     while (analyze_stack.size() > 0){
-        assert(reason(var(analyze_stack.last())) != CRef_Undef);
+        assert(reason(var(analyze_stack.last())) < CRef_Lazy);
         Clause& c = ca[reason(var(analyze_stack.last()))]; analyze_stack.pop();
 		
         for (int i = 1; i < c.size(); i++){
             Lit p  = c[i];
             if (!seen[var(p)] && level(var(p)) > 0){
-                if (reason(var(p)) != CRef_Undef && (abstractLevel(var(p)) & abstract_levels) != 0){
+                if (reason(var(p)) < CRef_Lazy && (abstractLevel(var(p)) & abstract_levels) != 0){
                     seen[var(p)] = 1;
                     analyze_stack.push(p);
                     analyze_toclear.push(p);
@@ -442,7 +558,7 @@ void Solver::analyzeFinal(Lit p, vec<Lit>& out_conflict)
     for (int i = trail.size()-1; i >= trail_lim[0]; i--){
         Var x = var(trail[i]);
         if (seen[x]){
-            if (reason(x) == CRef_Undef){
+            if (reason(x) >= CRef_Lazy){
                 assert(level(x) > 0);
                 out_conflict.push(~trail[i]);
             }else{
@@ -465,10 +581,6 @@ void Solver::uncheckedEnqueue(Lit p, CRef from)
     assigns[var(p)] = lbool(!sign(p));
     vardata[var(p)] = mkVarData(from, decisionLevel());
     trail.push_(p);
-
-    if(sign(p) && (var(p) >= (nbItems + nbTrans)))
-      totalWeight -= hu_wei[var(p)];
-	
 }
 
 
@@ -483,12 +595,14 @@ void Solver::uncheckedEnqueue(Lit p, CRef from)
  |    Post-conditions:
  |      * the propagation queue is empty, even if there was a conflict.
  |________________________________________________________________________________________________@*/
-CRef Solver::propagate()
+template<int M>
+CRef Solver::propagate_()
 {
     CRef    confl     = CRef_Undef;
     int     num_props = 0;
     watches.cleanAll();
 	
+  for (;;){
     while (qhead < trail.size()){
         Lit            p   = trail[qhead++];     // 'p' is enqueued fact to propagate.
         vec<Watcher>&  ws  = watches[p];
@@ -527,14 +641,7 @@ CRef Solver::propagate()
 			
             // Did not find watch -- clause is unit under assignment:
             *j++ = w;
-	    if(totalWeight < min_supp){
-	      confl = cr;
-	      qhead = trail.size();
-	      // Copy the remaining watches:                                                                                                 
-	      while (i < end)
-		*j++ = *i++;
-	    }
-            else if (value(first) == l_False){
+            if (value(first) == l_False){
                 confl = cr;
                 qhead = trail.size();
                 // Copy the remaining watches:
@@ -545,45 +652,312 @@ CRef Solver::propagate()
         NextClause:;
         }
         ws.shrink(i - j);
+
+        // Fail as soon as the remaining utility drops below minutil:
+        if (confl == CRef_Undef && (confl = propagateUtility(false)) != CRef_Undef)
+            qhead = trail.size();
     }
+    if (confl != CRef_Undef)
+        break;
+
+    // At the fixpoint, enqueue the items implied by the bound and go on with them:
+    int sz = trail.size();
+    if (M == modeBitset && (confl = propagateBitset()) != CRef_Undef)
+        break;
+    if (M == modeClosed && (confl = propagateClosure()) != CRef_Undef)
+        break;
+    if ((confl = propagateUtility(true)) != CRef_Undef || trail.size() == sz)
+        break;
+  }
     propagations += num_props;
     simpDB_props -= num_props;
 	
     return confl;
 }
 
+CRef Solver::propagate()
+{
+    switch (searchMode){
+    case modeAll:    return propagate_<modeAll>   ();
+    case modeClosed: return propagate_<modeClosed>();
+    default:         return propagate_<modeBitset>(); }
+}
+
+
+/*_________________________________________________________________________________________________
+ |
+ |  propagateUtility : (scan : bool)  ->  [Clause*]
+ |  
+ |  Description:
+ |    Linear utility constraint propagator. Subtracts the (transaction,item) pairs of the items and
+ |    transactions assigned false since the last call from 'totalWeight', the utility still reachable
+ |    under the current assignment, and returns CRef_Bound as soon as it is below minutil. If 'scan'
+ |    is set, every undefined item whose removal would lose more than the slack is enqueued true
+ |    (of reason CRef_Lazy, see 'analyze()').
+ |  
+ |  Note:
+ |    A pair is removed by whichever of its two literals is counted first, so 'countUtility()' skips
+ |    the partners already counted. Undoing in reverse trail order restores exactly the same pairs.
+ |________________________________________________________________________________________________@*/
+CRef Solver::propagateUtility(bool scan)
+{
+    for (; bhead < trail.size(); bhead++)
+        if (sign(trail[bhead]))
+            countUtility(var(trail[bhead]));
+
+    if (totalWeight < min_supp)
+        return CRef_Bound;
+
+    if (scan && totalWeight < scanWeight){
+        int slack = totalWeight - min_supp;
+        for (int i = 0; i < boundItems.size() && boundCut[i] > slack; i++){
+            Var x = boundItems[i];
+            if (value(x) == l_Undef && itemWeight[x] > slack)
+                uncheckedEnqueue(mkLit(x, false), CRef_Lazy);
+        }
+        scanWeight = totalWeight;
+    }
+
+    return CRef_Undef;
+}
+
+
+/*_________________________________________________________________________________________________
+ |
+ |  propagateBitset : ()  ->  [Clause*]
+ |  
+ |  Description:
+ |    Vertical counterpart of the support and closure clauses. Every item assigned true since the
+ |    last call removes the transactions outside its tidset from 'cover' and assigns them false.
+ |    Then, if anything was assigned, every item of 'closItems' whose tidset includes the cover is
+ |    implied true, or returns CRef_Closure if it is already false, as when the cover has no row of
+ |    'freshRows' left.
+ |________________________________________________________________________________________________@*/
+CRef Solver::propagateBitset()
+{
+    if (xhead == trail.size())
+        return CRef_Undef;
+
+    for (; xhead < trail.size(); xhead++){
+        Lit p = trail[xhead];
+        if (sign(p) || var(p) >= nbItems)
+            continue;
+        assert(tidOffset[var(p)] >= 0);
+        const uint64_t* tids = &tidsets[tidOffset[var(p)]];
+        for (int w = 0; w < tidWords; w++){
+            uint64_t kill = cover[w] & ~tids[w];
+            cover[w] &= tids[w];
+            for (; kill; kill &= kill - 1)
+                uncheckedEnqueue(mkLit(nbItems + (w << 6) + __builtin_ctzll(kill), true), CRef_Lazy);
+        }
+    }
+
+    // incremental run: a new transaction must be left
+    if (freshRows.size() > 0){
+        int w = 0;
+        while (w < tidWords && (cover[w] & freshRows[w]) == 0) w++;
+        if (w == tidWords){
+            closConfl = var_Undef;
+            return CRef_Closure; }
+    }
+
+    for (int i = 0; i < closItems.size(); i++){
+        Var q = closItems[i];
+        if (value(q) != l_True && bitSubset(&cover[0], &tidsets[tidOffset[q]], tidWords)){
+            if (value(q) == l_False){
+                closConfl = q;
+                return CRef_Closure; }
+            uncheckedEnqueue(mkLit(q, false), CRef_Closure);
+        }
+    }
+    xhead = trail.size();
+
+    return CRef_Undef;
+}
+
+
+/*_________________________________________________________________________________________________
+ |
+ |  propagateClosure : ()  ->  [Clause*]
+ |  
+ |  Description:
+ |    Closedness constraint of the items of 'closItems': an item contained in every transaction not
+ |    assigned false is implied true, or returns CRef_Closure if it is already false. The number of
+ |    such transactions missing q is 'outCount[q] - (nbFalseTrans - falseCount[q])', kept up to date
+ |    by walking the row of each transaction when it is assigned false.
+ |________________________________________________________________________________________________@*/
+CRef Solver::propagateClosure()
+{
+    for (; chead < trail.size(); chead++)
+        if (sign(trail[chead]) && var(trail[chead]) >= nbItems){
+            CsrRow<Lit> row = pathRows[var(trail[chead]) - nbItems];
+            for (int j = 0; j < row.size(); j++)
+                falseCount[var(row[j])]++;
+            nbFalseTrans++;
+        }
+
+    // the counters only move with false transactions, so nothing new can be implied otherwise
+    if (nbFalseTrans == closScan)
+        return CRef_Undef;
+    closScan = nbFalseTrans;
+
+    for (int i = 0; i < closItems.size(); i++){
+        Var q = closItems[i];
+        if (value(q) != l_True && outCount[q] == nbFalseTrans - falseCount[q]){
+            if (value(q) == l_False){
+                closConfl = q;
+                return CRef_Closure; }
+            uncheckedEnqueue(mkLit(q, false), CRef_Closure);
+        }
+    }
+
+    return CRef_Undef;
+}
+
+
+void Solver::uncountClosure(Var x)
+{
+    CsrRow<Lit> row = pathRows[x - nbItems];
+    for (int j = 0; j < row.size(); j++)
+        falseCount[var(row[j])]--;
+    nbFalseTrans--;
+}
+
+
+/*_________________________________________________________________________________________________
+ |
+ |  localUtility : (z : Var) (limit : int)  ->  [int]
+ |  
+ |  Description:
+ |    Local utility of 'z' (EFIM): the remaining utility of the transactions containing 'z' that
+ |    are not false. No itemset of the current branch containing 'z' can be worth more. The sum
+ |    stops as soon as it reaches 'limit'.
+ |  
+ |  Note:
+ |    The remaining utilities of all the transactions not counted false add up to 'totalWeight', so
+ |    for a dense item the sum is taken over the (fewer) transactions without it and subtracted.
+ |
+ |    The branching order is that of the heap, not a fixed order on the items: every undecided item
+ |    may still extend the itemset, so this is also the subtree utility of 'z' (EFIM) for that
+ |    order. It is computed when 'z' is picked rather than kept up to date: an item counted false
+ |    changes 'transWeight' in each of its transactions, and so the bound of every item they hold.
+ |________________________________________________________________________________________________@*/
+int Solver::localUtility(Var z, int limit)
+{
+    if (complement[z]){
+        assert(bhead == trail.size());
+        int out = 0;
+        for (int j = 0; j < local_out[z].size() && totalWeight - out >= limit; j++)
+            if (!counted[var(local_out[z][j])])
+                out += transWeight[var(local_out[z][j])];
+        return totalWeight - out;
+    }
+
+    CsrRow<Lit> col = local_trans[z];
+    int lu = 0;
+    for (int j = 0; j < col.size() && lu < limit; j++){
+        Var t = var(col[j]);
+        if (value(t) != l_False)
+            lu += transWeight[t];
+    }
+    return lu;
+}
+
+
+void Solver::countUtility(Var x)
+{
+    counted[x] = 1;
+    if (x < nbItems){
+        totalWeight -= itemWeight[x];
+        CsrRow<Lit> col  = local_trans[x];
+        CsrRow<int> util = local_util [x];
+        for (int j = 0; j < col.size(); j++){
+            Var t = var(col[j]);
+            if (!counted[t]) transWeight[t] -= util[j]; }
+    }else{
+        CsrRow<Lit> row  = pathRows[x - nbItems];
+        CsrRow<int> util = pathUtil[x - nbItems];
+        totalWeight -= transWeight[x];
+        supportLeft -= pathCount[x - nbItems];
+        for (int j = 0; j < row.size(); j++){
+            Var v = var(row[j]);
+            if (!counted[v]) itemWeight[v] -= util[j]; }
+    }
+}
+
+
+void Solver::uncountUtility(Var x)
+{
+    counted[x] = 0;
+    if (x < nbItems){
+        CsrRow<Lit> col  = local_trans[x];
+        CsrRow<int> util = local_util [x];
+        for (int j = 0; j < col.size(); j++){
+            Var t = var(col[j]);
+            if (!counted[t]) transWeight[t] += util[j]; }
+        totalWeight += itemWeight[x];
+    }else{
+        CsrRow<Lit> row  = pathRows[x - nbItems];
+        CsrRow<int> util = pathUtil[x - nbItems];
+        for (int j = 0; j < row.size(); j++){
+            Var v = var(row[j]);
+            if (!counted[v]) itemWeight[v] += util[j]; }
+        totalWeight += transWeight[x];
+        supportLeft += pathCount[x - nbItems];
+    }
+}
+
 
 /*_________________________________________________________________________________________________
  |
  |  reduceDB : ()  ->  [void]
  |  
  |  Description:
- |    Remove half of the learnt clauses, minus the clauses locked by the current assignment. Locked
- |    clauses are clauses that are reason to some assignment. Binary clauses are never removed.
+ |    Release all the clauses of the finished guiding path. They all live in the region of 'ca'
+ |    opened by 'EncodeDB()', so the allocator is reset to its mark and the watcher lists are
+ |    truncated instead of detaching and freeing the clauses one by one. The transaction variables
+ |    are renumbered by the next path, so their watcher lists are freed as well.
+ |  
+ |  Note:
+ |    Must be called at level 0 with an empty trail: no clause may be the reason of an assignment.
  |________________________________________________________________________________________________@*/
+void Solver::reduceDB()
+{
+    assert(trail.size() == 0);
+    for (Var v = 0; v < nVars(); v++){
+        watches[mkLit(v, false)].clear(v >= nbItems);
+        watches[mkLit(v, true )].clear(v >= nbItems); }
+    clauses.clear();
+    learnts.clear();
+    clauses_literals = learnts_literals = 0;
+    ca.popRegion();
+}
+
+
 struct reduceDB_lt { 
     ClauseAllocator& ca;
     reduceDB_lt(ClauseAllocator& ca_) : ca(ca_) {}
     bool operator () (CRef x, CRef y) { 
         return ca[x].size() > 2 && (ca[y].size() == 2 || ca[x].activity() < ca[y].activity()); } 
 };
-void Solver::reduceDB()
+
+// Remove half of the learnt clauses of the path, minus the binary and locked ones and plus those of
+// tiny activity. Their memory comes back with the region of the path, see 'reduceDB()'.
+void Solver::reduceLearnts()
 {
     int     i, j;
-    //double  extra_lim = cla_inc / learnts.size();    // Remove any clause below this activity
-	
-    //sort(learnts, reduceDB_lt(ca));
-    // Don't delete binary or locked clauses. From the rest, delete clauses from the first half
-    // and clauses with activity smaller than 'extra_lim':
-    for (i = j = 0; i < clauses.size(); i++){
-        Clause& c = ca[clauses[i]];
-        if (1)//c.size() > 2 && !locked(c) && (i < learnts.size() / 2 || c.activity() < extra_lim))
-            removeClause(clauses[i]);
+    double  extra_lim = cla_inc / learnts.size();    // Remove any clause below this activity
+
+    sort(learnts, reduceDB_lt(ca));
+    for (i = j = 0; i < learnts.size(); i++){
+        Clause& c = ca[learnts[i]];
+        if (c.size() > 2 && !locked(c) && (i < learnts.size() / 2 || c.activity() < extra_lim))
+            removeClause(learnts[i]);
         else
-            clauses[j++] = clauses[i];
+            learnts[j++] = learnts[i];
     }
-    clauses.shrink(i - j);
-    //checkGarbage();
+    learnts.shrink(i - j);
+    max_learnts *= learntsize_inc;
 }
 
 
@@ -677,20 +1051,21 @@ void Solver::simplifier(){
  |    if the clause set is unsatisfiable. 'l_Undef' if the bound on number of conflicts is reached.
  |________________________________________________________________________________________________@*/
 //search-based DPLL procedure
-lbool Solver::search(int nof_conflicts, Cooperation* coop)
+template<int M>
+lbool Solver::search_(int nof_conflicts, Cooperation* coop)
 {
   //assert(ok);
-   // int       backtrack_level;
+    int         backtrack_level;
     int         conflictC = 0;
     vec<Lit>    learnt_clause;
     lbool       answer;
     starts++;
-    ind += coop->nbThreads; 	
     
     for (;;){
       
     Prop:;	
-        CRef confl = propagate();
+        if (asynch_interrupt) return l_Undef;      // the path is left unfinished
+        CRef confl = propagate_<M>();
         if (!ok || confl != CRef_Undef){
             // CONFLICT
             conflicts++; conflictC++;
@@ -701,43 +1076,33 @@ lbool Solver::search(int nof_conflicts, Cooperation* coop)
 	      goto div_section;
 	    }
 
-	    Lit q = trail[trail_lim[trail_lim.size()-1]];
-	    int backtrack_level = decisionLevel()-1;
-	    cancelUntil(decisionLevel()-1);
-	    uncheckedEnqueue(~q);
+	    learnt_clause.clear();
+	    analyze(confl, learnt_clause, backtrack_level);
+	    if (!backjump_<M>(learnt_clause, backtrack_level)) {
+	      diviser_state = 0;
+	      cancelAll();
+	      goto div_section;
+	    }
+	    varDecayActivity();
+	    claDecayActivity();
 	    
 	 }else{
 
 	div_section:;
-	  if (diviser_state == 0)
-	    if(ind < allItems.size()) {
+	  if (diviser_state == 0){
+	    endPath(coop, true);
+	    ind = coop->nextGuidingPath();
+	    if(ind < coop->VecGuiding.size()) {
 	      ok = true;
 	      reduceDB();
-
-	      while((ind < allItems.size())  && !encodeGuidingPath(coop, ind+1))
-		ind += coop->nbThreads;
-	      
-	      if(ind >=  allItems.size())
+	      if(!takeGuidingPath(coop))
 		return l_False;
 	      diviser_state = 1;
-	      ind += coop->nbThreads;
 	      goto Prop;
 	    }else
 	      return l_False;
-	  
-	  if(totalWeight < coop->min_supp){
-	    conflicts++;
-	    if (decisionLevel() == 0) {
-	      diviser_state = 0;
-	      cancelAll();
-	      goto div_section;
-	    }
-	    // cancelUntil(backtrack_level);
-	    Lit l = trail[trail_lim[decisionLevel()-1]];
-	    cancelUntil(decisionLevel()-1);
-	    uncheckedEnqueue(~l);
-	    goto Prop;
 	  }
+	  
 	  Lit next = lit_Undef;
 	  while (decisionLevel() < assumptions.size()){
 	    // Perform user provided assumption:
@@ -746,7 +1111,7 @@ lbool Solver::search(int nof_conflicts, Cooperation* coop)
 	      // Dummy decision level:
 	      newDecisionLevel();
                 }else if (value(p) == l_False){
-	      cancelUntil(0);
+	      cancelUntil_<M>(0);
 	      diviser_state = 0;
 	      cancelAll();
 	      goto div_section;
@@ -757,34 +1122,46 @@ lbool Solver::search(int nof_conflicts, Cooperation* coop)
 	  }
 	  
 	  if (next == lit_Undef){
+	    // A threshold raised by the top-k itemsets found so far prunes the current branch too:
+	    if (coop->topk > 0 && coop->threshold() > min_supp){
+	      min_supp   = coop->threshold();
+	      scanWeight = INT32_MAX;
+	      goto Prop;
+	    }
+
+	    if (learnts.size() >= max_learnts)
+	      reduceLearnts();
+
 	    // New variable decision:
-	    decisions++;
 	    next = pickBranchLit();
 	    
 	    if (next == lit_Undef){
 
-	      nbModels++;
-	      if(verbosity >= 3){
-		printf("->  ");
+	      // the false items and transactions are all counted out: what is left is the itemset
+	      if(coop->wantItems()){
+		outItems.clear();
 		for(int i = 0; i < VecItems.size(); i++)
 		  if(value(mkLit(VecItems[i], false)) == l_True)
-		    printf("%d ", VecItems[i] + 1);
-		printf("\n");
+		    outputItem(coop, VecItems[i]);
 	      }
+	      foundItemset(coop, totalWeight, supportLeft);
 	      	      
-	      if (decisionLevel() == 0) {
+	      if (!refute_<M>()) {
 		diviser_state = 0;
 		cancelAll();
 		goto div_section;
 	      }
-	      int last = trail_lim.size();
-	      Lit q = trail[trail_lim[last-1]];
-	      cancelUntil(decisionLevel()-1);
-	      uncheckedEnqueue(~q);
+	      goto Prop;
+	    }
+
+	    // Refute the item at once if its local utility cannot reach minutil:
+	    if (localUtility(var(next), min_supp) < min_supp){
+	      uncheckedEnqueue(~next, CRef_Lazy);
 	      goto Prop;
 	    }
 	  }
 	  // Increase decision level and enqueue 'next'
+	  decisions++;
 	  newDecisionLevel();
 	  uncheckedEnqueue(next);
         }
@@ -792,6 +1169,75 @@ lbool Solver::search(int nof_conflicts, Cooperation* coop)
 }
 
 
+/*_________________________________________________________________________________________________
+ |
+ |  backjump_ : (learnt : vec<Lit>&) (btlevel : int)  ->  [bool]
+ |
+ |  Description:
+ |    Learns the clause of a conflict analyzed by 'analyze()' and asserts its first literal. The
+ |    search backjumps to 'btlevel', but not below the last refuted decision: the itemsets with that
+ |    decision true are enumerated already, and would be again. If the conflict is at the level of
+ |    that decision, the previous one is refuted instead, see 'refute_()', and the clause asserted
+ |    there if it is unit. False if no decision is left to refute.
+ |________________________________________________________________________________________________@*/
+template<int M>
+bool Solver::backjump_(vec<Lit>& learnt, int btlevel)
+{
+    CRef cr = CRef_Undef;
+    int  f  = lastRefuted();
+    if (learnt.size() > 1){
+        cr = ca.alloc(learnt, true);
+        learnts.push(cr);
+        attachClause(cr);
+        claBumpActivity(ca[cr]);
+    }else if (f > 0)
+        cr = ca.alloc(learnt, true);     // a unit asserted above level 0 needs a reason, not watched
+
+    if (f < decisionLevel())
+        cancelUntil_<M>(btlevel > f ? btlevel : f);
+    else if (!refute_<M>())
+        return false;
+    else if (learnt.size() > 1 && btlevel >= decisionLevel())
+        return true;
+    uncheckedEnqueue(learnt[0], cr);
+    return true;
+}
+
+
+// Refute the last decision that is not a refutation itself, as the decision of its own level (the
+// decisions are positive, the refutations negative): the itemsets with it true are all enumerated.
+template<int M>
+bool Solver::refute_()
+{
+    int l = decisionLevel();
+    while (l > 0 && sign(trail[trail_lim[l-1]])) l--;
+    if (l == 0)
+        return false;
+    Lit q = trail[trail_lim[l-1]];
+    cancelUntil_<M>(l-1);
+    newDecisionLevel();
+    uncheckedEnqueue(~q);
+    return true;
+}
+
+
+int Solver::lastRefuted() const
+{
+    int l = decisionLevel();
+    while (l > 0 && !sign(trail[trail_lim[l-1]])) l--;
+    return l;
+}
+
+
+lbool Solver::search(int nof_conflicts, Cooperation* coop)
+{
+    switch (searchMode){
+    case modeAll:    return search_<modeAll>   (nof_conflicts, coop);
+    case modeClosed: return search_<modeClosed>(nof_conflicts, coop);
+    default:         return search_<modeBitset>(nof_conflicts, coop); }
+}
+
+
 double Solver::progressEstimate() const
 {
     double  progress = 0;
@@ -842,23 +1288,19 @@ lbool Solver::solve_(Cooperation* coop)
   nbModels = 0;
   diviser_state = 1;
   nbClauses = 0;
-  max_clauses = 100;
+  encodeTime = 0;
+  smallTime = 0;
+  pathStats.clear();
+  pathStart = -1;
 
   if (!ok) return l_False;
   
-  ind = threadId;
-  while((ind < allItems.size())  && !encodeGuidingPath(coop, ind+1)){
-    ind += coop->nbThreads;
-  }
-  if(ind >=  allItems.size())
+  ind = coop->nextGuidingPath();
+  if(!takeGuidingPath(coop))
     return l_False;
   
-  nbModels = 0;
-  
   solves++;
-  tailUnitLit = 0;
   
-  max_learnts               = nClauses() * learntsize_factor;
   learntsize_adjust_confl   = learntsize_adjust_start_confl;
   learntsize_adjust_cnt     = (int)learntsize_adjust_confl;
   lbool   status            = l_Undef;
@@ -872,6 +1314,7 @@ lbool Solver::solve_(Cooperation* coop)
     if (!withinBudget()) break;
     curr_restarts++;
   }
+  endPath(coop, false);
   
   if ((threadId == 0) && (verbosity >= 1))
     printf(" =======================================================================================================================\n");
@@ -895,16 +1338,22 @@ void Solver::EncodeDB(Cooperation* coop){
   nbItems = nVars();
   diviser_state = 1;
   min_supp = coop->min_supp;
+  histBase = coop->min_supp;
+  utilHist.clear();
+  utilHist.growTo(32, 0);
+  sweepHist.clear();
+  sweepHist.growTo(coop->sweep.size(), 0);
+  bitsetMode = coop->bitset;
+  searchMode = bitsetMode ? modeBitset : coop->enum_clos == 1 ? modeClosed : modeAll;
   
+  // every clause from now on belongs to a guiding path and is released by 'reduceDB()'
+  ca.pushRegion();
   for(int i = 0; i < nVars(); i++){
-    local_trans.push();
+    local_out.push();
+    complement.push(0);
+    inProj.push(0);
     occ.push(0);
   }
-  
-  for( int i= 0; i< nbTrans; i++){
-    Var v = newVar();
-    isTrans[v]=1;
-  }
 }
 
 
@@ -920,13 +1369,19 @@ void Solver::EncodeDB(Cooperation* coop){
  |    if the clause set is unsatisfiable. 'l_Undef' if the bound on number of conflicts is reached.                                                                                                        
  |________________________________________________________________________________________________@*/
 //Encoding phase
-bool Solver::encodeGuidingPath(Cooperation* coop, int index){
+bool Solver::encodeGuidingPath(Cooperation* coop, int path){
 
+  min_supp = coop->threshold();
   items.clear();
+  vec<Lit>& guide = coop->VecGuiding[path];
+  int index = coop->guidingIndex[path];
   Lit p = allItems[index-1];
   Lit pp = p;
   vec<Lit> currentDB;
-  if(coop->wocc[var(p)] < coop->min_supp)
+  if(coop->wocc[var(p)] < min_supp)
+    return false;
+  CsrRow<int> appear = (*dbAppear)[var(p)];
+  if(appear.size() == 0 || appear[appear.size()-1] < coop->firstNew)
     return false;
   //propagate at level 0 the guding path literals
   int i = 0;
@@ -935,88 +1390,271 @@ bool Solver::encodeGuidingPath(Cooperation* coop, int index){
     seen[var(allItems[i])]    = 1;
   }
   uncheckedEnqueue(allItems[i]);
+  // secondary literals of a split path: only transactions holding all its positive items remain
+  int nbPos = 0;
+  for(int k = 1; k < guide.size(); k++){
+    uncheckedEnqueue(guide[k]);
+    if(!sign(guide[k])){
+      seenItem[var(guide[k])] = 1;
+      nbPos++;
+    }
+  }
   
-  int current_dabase_size = coop->appearTrans[var(p)].size();
+  int current_dabase_size = appear.size();
   Lit qlit = lit_Undef;
 
-  int init_vars = nbItems + nbTrans;
   totalWeight   = 0;
   int wcurTrans = 0;    
+  boundItems.clear();
+  boundCut.clear();
+  nbFalseTrans = 0;
+  tidsets.clear();
+  closItems.clear();
+  for(int i = 0; i < nbItems; i++){
+    itemWeight[i] = 0;
+    tidOffset[i]  = -1;
+    falseCount[i] = 0;
+    local_out[i].clear();
+    complement[i] = 0;
+    inProj[i]     = 0;
+    mergedNext[i] = var_Undef;
+  }
+
+  local_trans.shape(nbItems);
+  local_util .shape(nbItems);
 
-  vec<int> poids;
-  vec<Lit> rlits;
+  // transactions of the path, with its items and their local support
+  vec<int> selected;
   for(int i = 0; i < current_dabase_size; i++){
-    int num = coop->appearTrans[var(p)][i];
-    qlit = mkLit(num + nbItems, false);
-    currentDB.push(mkLit(num + nbItems, false));
+    int num = appear[i];
+    CsrRow<Lit> trans = (*dbTrans)[num];
+    CsrRow<int> util  = (*dbUtil)[num];
+    if(nbPos > 0){
+      int cpt = 0;
+      for(int j = 0; j < trans.size(); j++)
+	cpt += seenItem[var(trans[j])];
+      if(cpt < nbPos)
+	continue;
+    }
+    selected.push(num);
 
     wcurTrans = 0;
-    for(int j = 0; j < coop->list_transactions[num].size(); j++){
-      Lit r = coop->list_transactions[num][j]; 
-      Var v = var(r);   
-      if(value (r) != l_False){
-	// add boolean function to ....
-	Lit a = lit_Undef;
-	if (init_vars < nVars()){
-	  a = mkLit(init_vars++, false);
-	}else{
-	  a = mkLit(newVar(), false);
-	  init_vars++;
-	}	
-	rlits.push(a);
-	addClause(~a, qlit);
-	addClause(~a, r);
-	hu_wei[var(a)] = coop->wItemTrans[num][j];
-	totalWeight   += coop->wItemTrans[num][j];
-	wcurTrans     += coop->wItemTrans[num][j];
+    for(int j = 0; j < trans.size(); j++){
+      Lit r = trans[j]; 
+      if(value (r) != l_False)
+	wcurTrans += util[j];
+      if(!seen[var(r)]){
+	seen[var(r)] = 1;
+	items.push(r);
       }
-      local_trans[v].push(qlit);
-      if(!seen[v]){
-	seen[v] = 1;
-	items.push(coop->list_transactions[num][j]);
+    }
+    for(int j = 0; j < trans.size(); j++)
+      occ[var(trans[j])]  += wcurTrans;
+  }
+
+  // the transactions are projected on the items not false at level 0 and, in closed mode, on all
+  // the items checked for closure
+  inProj[var(p)] = 1;
+  for(int i = 0; i < items.size(); i++)
+    inProj[var(items[i])] = coop->enum_clos == 1 || value(items[i]) != l_False;
+  if(coop->enum_clos == 1)
+    for(int i = coop->div_begining; i < index-1; i++)
+      if(min_supp <= occ[var(allItems[i])])
+	inProj[var(allItems[i])] = 1;
+
+  projRows.clear();
+  projUtil.clear();
+  projHash.clear();
+  for(int i = 0; i < selected.size(); i++){
+    CsrRow<Lit> trans = (*dbTrans)[selected[i]];
+    CsrRow<int> util  = (*dbUtil)[selected[i]];
+    uint32_t    h     = 2166136261u;
+    projRows.push();
+    projUtil.push();
+    for(int j = 0; j < trans.size(); j++)
+      if(inProj[var(trans[j])]){
+	projRows.push(trans[j]);
+	projUtil.push(util[j]);
+	h = (h ^ toInt(trans[j])) * 16777619u;
       }
+    projHash.push(h);
+  }
+
+  // identical projections are merged into one transaction with the utilities summed (the rows of
+  // the database are sorted by item, see 'Cooperation::pruneItems()')
+  vec<int> proj;
+  for(int i = 0; i < selected.size(); i++)
+    proj.push(i);
+  ProjRow_lt lt(projRows, projHash);
+  sort(proj, lt);
+  pathRows.clear();
+  pathUtil.clear();
+  pathCount.clear();
+  pathFresh.clear();
+  supportLeft = selected.size();
+  int fresh = 0;
+  for(int i = 0; i < proj.size(); i++){
+    CsrRow<Lit> row  = projRows[proj[i]];
+    CsrRow<int> util = projUtil[proj[i]];
+    if(i > 0 && lt.same(proj[i-1], proj[i])){
+      CsrRow<int> sum = pathUtil[pathUtil.size()-1];
+      for(int j = 0; j < util.size(); j++)
+	sum[j] += util[j];
+      pathCount.last()++;
+      if(selected[proj[i]] >= coop->firstNew && !pathFresh.last())
+	pathFresh.last() = 1, fresh++;
+      continue;
     }
-    poids.push(wcurTrans);
-    for(int j = 0; j < coop->list_transactions[num].size(); j++){
-      Lit r = coop->list_transactions[num][j]; 
-      occ[var(r)]  += wcurTrans;
+    pathRows.push();
+    pathUtil.push();
+    pathCount.push(1);
+    pathFresh.push(selected[proj[i]] >= coop->firstNew);
+    fresh += pathFresh.last();
+    for(int j = 0; j < row.size(); j++){
+      pathRows.push(row[j]);
+      pathUtil.push(util[j]);
     }
-    
   }
 
   for(int i = 0; i < items.size(); i++)
     seen[var(items[i])] = 0;
   for(int i = 0; i < index; i++)
     seen[var(allItems[i])] = 0;
+  for(int k = 1; k < guide.size(); k++)
+    seenItem[var(guide[k])] = 0;
+
+  // few distinct transactions: searching them directly is cheaper than encoding them (and with no
+  // new transaction, nothing is to be mined in an incremental run)
+  if(fresh == 0 || pathRows.size() <= coop->smallPath){
+    for(int i = 0; i < allItems.size(); i++)
+      occ [var(allItems[i])]  = 0;
+    if(fresh > 0){
+      openPath(path, var(pp), items.size());
+      mineSmallPath(coop);
+    }
+    cancelAll();
+    return false;
+  }
 
-  for(int i = 0; i < items.size(); i++){
-    if(value(items[i]) == l_Undef && occ[var(items[i])] < coop->min_supp){
-      uncheckedEnqueue(~items[i]);
-      propagate();
+  if(coop->enum_clos == 1)
+    mergePathItems();
+
+  for(int i = 0; i < pathRows.size(); i++){
+    // transaction variables are numbered densely per path, after the items
+    Var t = nbItems + i;
+    if(t == nVars()){
+      newVar(true, false);
+      isTrans[t] = 1;
+    }
+    qlit = mkLit(t, false);
+    currentDB.push(qlit);
+
+    CsrRow<Lit> row  = pathRows[i];
+    CsrRow<int> util = pathUtil[i];
+    transWeight[t] = 0;
+    for(int j = 0; j < row.size(); j++){
+      Var v = var(row[j]);
+      int w = util[j];
+      // every pair is weighted, the level-0 false items left are counted by the bound propagator
+      itemWeight[v]  += w;
+      transWeight[t] += w;
+      totalWeight    += w;
+      local_trans.grow(v);
+      local_util .grow(v);
     }
   }
 
-  if( coop->min_supp <= totalWeight){
-    // add support constraints of items in database of D under the scope of p
-    for(int i = 0; i < coop->appearTrans[var(p)].size(); i++){
-      int num = coop->appearTrans[var(p)][i];
-      add_support_constraints(num+nbItems, coop->list_transactions[num], items); 
+  // columns of the path, filled in the order of its transactions
+  local_trans.alloc();
+  local_util .alloc();
+  for(int i = 0; i < pathRows.size(); i++){
+    CsrRow<Lit> row  = pathRows[i];
+    CsrRow<int> util = pathUtil[i];
+    for(int j = 0; j < row.size(); j++){
+      local_trans.fill(var(row[j]), currentDB[i]);
+      local_util .fill(var(row[j]), util[j]);
     }
-    // add closure constraints of items in database of D under the scope of p
-    if(coop->enum_clos == 1){
-      for(int i = 0; i < items.size(); i++){
-	Lit q = items[i];
-	if(value(q) != l_True)
-	  add_closure_constraints(q, currentDB, local_trans[var(q)]);
-      }
-      // add closure constraints of items in database of D under the scope of p
-      for(int i = coop->div_begining; i < index-1; i++){ 
-	Lit q = allItems[i];
-	//if(coop->appearTrans[var(q)].size() >= coop->min_supp)
-	if(coop->min_supp <= occ[var(allItems[i])])
-	  add_closure_constraints(currentDB, local_trans[var(q)]);
+  }
+
+  // vertical database of the path: one tidset per item (and per excluded prefix item checked for
+  // closure) over the transaction variables
+  if(bitsetMode){
+    tidWords = bitWords(currentDB.size());
+    vec<Var> tidItems;
+    for(int i = 0; i < items.size(); i++)
+      tidItems.push(var(items[i]));
+    if(coop->enum_clos == 1)
+      for(int i = coop->div_begining; i < index-1; i++)
+	if(min_supp <= occ[var(allItems[i])])
+	  tidItems.push(var(allItems[i]));
+    for(int i = 0; i < tidItems.size(); i++){
+      Var v = tidItems[i];
+      tidOffset[v] = tidsets.size();
+      tidsets.growTo(tidsets.size() + tidWords, 0);
+      CsrRow<Lit> col = local_trans[v];
+      for(int j = 0; j < col.size(); j++)
+	bitSet(&tidsets[tidOffset[v]], var(col[j]) - nbItems);
+    }
+    cover.clear();
+    cover.growTo(tidWords, 0);
+    for(int i = 0; i < currentDB.size(); i++)
+      bitSet(&cover[0], i);
+  }
+
+  // local utility fixpoint: removing an item lowers the remaining utility of its transactions,
+  // which may in turn disqualify other items
+  for(bool changed = true; changed && propagateUtility(false) == CRef_Undef; ){
+    changed = false;
+    for(int i = 0; i < items.size(); i++)
+      if(value(items[i]) == l_Undef && localUtility(var(items[i]), min_supp) < min_supp){
+	uncheckedEnqueue(~items[i]);
+	changed = true;
       }
-    } 
+  }
+
+  propagateUtility(false);
+
+  // items checked by the utility bound, heaviest first
+  for(int i = 0; i < items.size(); i++)
+    if(value(items[i]) == l_Undef)
+      boundItems.push(var(items[i]));
+  sort(boundItems, ItemWeight_gt(itemWeight));
+  for(int i = 0; i < boundItems.size(); i++)
+    boundCut.push(itemWeight[boundItems[i]]);
+
+  // closedness of the items of the path and of the prefix items already processed
+  if(coop->enum_clos == 1){
+    for(int i = 0; i < items.size(); i++)
+      if(value(items[i]) != l_True)
+	closItems.push(var(items[i]));
+    for(int i = coop->div_begining; i < index-1; i++)
+      if(min_supp <= occ[var(allItems[i])])
+	closItems.push(var(allItems[i]));
+    for(int i = 0; i < closItems.size(); i++)
+      outCount[closItems[i]] = currentDB.size() - local_trans.size(closItems[i]);
+  }
+
+  if(bitsetMode)
+    xhead = 0; // check the closure of the level-0 assignment
+  else if( min_supp <= totalWeight){
+    // add support constraints of items in database of D under the scope of p
+    for(int i = 0; i < currentDB.size(); i++)
+      add_support_constraints(var(currentDB[i]), pathRows[i], items); 
+  }
+
+  // incremental run: the itemset must be in a new transaction
+  freshRows.clear();
+  if(fresh < currentDB.size() && bitsetMode){
+    freshRows.growTo(tidWords, 0);
+    for(int i = 0; i < currentDB.size(); i++)
+      if(pathFresh[i])
+	bitSet(&freshRows[0], i);
+  }else if(fresh < currentDB.size()){
+    vec<Lit> lits;
+    for(int i = 0; i < currentDB.size(); i++)
+      if(pathFresh[i])
+	lits.push(currentDB[i]);
+    addClause(lits);
   }
   
   // reorder the heap with real variables appearing in the DB under the scope of current guiding path variable
@@ -1024,89 +1662,485 @@ bool Solver::encodeGuidingPath(Cooperation* coop, int index){
   for(int i = 0; i < items.size(); i++){
       Lit q = items[i];
       if(value(q) == l_Undef){
-	activity[var(q)] = current_dabase_size - local_trans[var(q)].size();
+	CsrRow<Lit> col = local_trans[var(q)];
+	activity[var(q)] = currentDB.size() - col.size();
 	vs.push(var(q));
+	// dense item: its local utility is cheaper to get from the transactions without it
+	if(2 * col.size() > currentDB.size()){
+	  complement[var(q)] = 1;
+	  for(int j = 0; j < col.size(); j++) seen[var(col[j])] = 1;
+	  for(int j = 0; j < currentDB.size(); j++)
+	    if(!seen[var(currentDB[j])])
+	      local_out[var(q)].push(currentDB[j]);
+	  for(int j = 0; j < col.size(); j++) seen[var(col[j])] = 0;
+	}
       }
   }
   order_heap.build(vs);
   
-  for(int i = 0; i < allItems.size(); i++){
-    Var v = var(allItems[i]);
-    local_trans[v].clear();
-    occ [v]  = 0;
-  }
-    
-  if(clauses.size() > max_clauses){
-     checkGarbage();
-     max_clauses *= 1.1;//*= 1.1;
-   }else
-    max_clauses *= 0.9;
- 
+  for(int i = 0; i < allItems.size(); i++)
+    occ [var(allItems[i])]  = 0;
+
+  // opened here, the times are set by 'takeGuidingPath()' and 'endPath()'
+  openPath(path, var(pp), items.size());
   
   return true;
 }
 
 
-/*********************************************************************************
-//@ add_support_constraints : closure constraint
+/*_________________________________________________________________________________________________
+ |
+ |  mergePathItems : ()  ->  [void]
+ |
+ |  Description:
+ |    Closed mode: the undecided items of the path in the same transactions ('pathRows') are in the
+ |    same closed itemsets of the path. Each is merged into the first of them, which gets its
+ |    utilities in the rows and is the only one left in 'items', and is chained after it in
+ |    'mergedNext' for the output.
+ |________________________________________________________________________________________________@*/
+void Solver::mergePathItems()
+{
+  // same support and hash of their rows first, then compared on the rows
+  vec<uint32_t> hash(nbItems, 2166136261u);
+  vec<int>      sup (nbItems, 0);
+  vec<Var>      cand;
+  for(int i = 0; i < pathRows.size(); i++){
+    CsrRow<Lit> row = pathRows[i];
+    for(int j = 0; j < row.size(); j++)
+      if(value(row[j]) == l_Undef){
+	Var v = var(row[j]);
+	hash[v] = (hash[v] ^ i) * 16777619u;
+	sup [v]++;
+      }
+  }
+  for(int i = 0; i < items.size(); i++)
+    if(value(items[i]) == l_Undef)
+      cand.push(var(items[i]));
+  ItemKey_lt lt(sup, hash);
+  sort(cand, lt);
+
+  int n = 0;
+  for(int i = 1; i < cand.size(); i++)
+    if(lt.same(cand[i-1], cand[i]))
+      seenItem[cand[i-1]] = seenItem[cand[i]] = 1, n++;
+  if(n == 0)
+    return;
 
-*********************************************************************************/
-void Solver::add_closure_constraints(Lit item, vec<Lit>& trans, vec<Lit>& app){
-    vec<Lit> liste;
-    for(int i = 0; i < app.size(); i++) seen[var(app[i])] = 1;    
-    for(int i = 0; i < trans.size(); i++)
-      if(!seen[var(trans[i])])
-        liste.push(trans[i]);
-    liste.push(item);
-    addClause(liste);
-
-    for(int i = 0; i < app.size(); i++) seen[var(app[i])] = 0;
+  Csr<int> cols;
+  cols.shape(nbItems);
+  for(int i = 0; i < pathRows.size(); i++){
+    CsrRow<Lit> row = pathRows[i];
+    for(int j = 0; j < row.size(); j++)
+      if(seenItem[var(row[j])])
+	cols.grow(var(row[j]));
+  }
+  cols.alloc();
+  for(int i = 0; i < pathRows.size(); i++){
+    CsrRow<Lit> row = pathRows[i];
+    for(int j = 0; j < row.size(); j++)
+      if(seenItem[var(row[j])])
+	cols.fill(var(row[j]), i);
   }
 
+  // the first of a class is its least item, so it comes first in the (sorted) rows
+  vec<Var> into(nbItems, var_Undef);
+  n = 0;
+  for(int i = 0, r = 0; i < cand.size(); i++){
+    Var v = cand[i], q = cand[r];
+    seenItem[v] = 0;
+    if(i > r && lt.same(q, v) && memcmp((int*)cols[q], (int*)cols[v], sup[v] * sizeof(int)) == 0){
+      into[v]       = q;
+      mergedNext[v] = mergedNext[q];
+      mergedNext[q] = v;
+      n++;
+    }else
+      r = i;
+  }
+  if(n == 0)
+    return;
 
-/*********************************************************************************
-//@ add_closure_constraints : closure constraint
+  Csr<Lit> rows;
+  Csr<int> utils;
+  for(int i = 0; i < pathRows.size(); i++){
+    CsrRow<Lit> row  = pathRows[i];
+    CsrRow<int> util = pathUtil[i];
+    rows .push();
+    utils.push();
+    for(int j = 0; j < row.size(); j++){
+      Var v = var(row[j]);
+      if(into[v] == var_Undef){
+	sup[v] = rows.size(i);
+	rows .push(row[j]);
+	utils.push(util[j]);
+      }else
+	utils[i][sup[into[v]]] += util[j];
+    }
+  }
+  rows .moveTo(pathRows);
+  utils.moveTo(pathUtil);
 
-*********************************************************************************/
-void Solver::add_closure_constraints(vec<Lit>& trans, vec<Lit>& app){
-  vec<Lit> liste;
-  for(int i = 0; i < app.size(); i++) seen[var(app[i])] = 1; 
-  for(int i = 0; i < trans.size(); i++)
-    if(!seen[var(trans[i])])
-      liste.push(trans[i]);
-  addClause(liste);
-  
-  for(int i = 0; i < app.size(); i++) seen[var(app[i])] = 0;
+  int k = 0;
+  for(int i = 0; i < items.size(); i++)
+    if(into[var(items[i])] == var_Undef)
+      items[k++] = items[i];
+  items.shrink(items.size() - k);
+}
+
+
+/*_________________________________________________________________________________________________
+ |
+ |  takeGuidingPath : (coop : Cooperation*)  ->  [bool]
+ |
+ |  Description:
+ |    Encodes the guiding path 'ind', or the next one that is not empty (taken from 'coop') if it is.
+ |    The small paths met on the way are mined at once, see 'mineSmallPath()'. False if no path is
+ |    left to search, or once interrupted.
+ |________________________________________________________________________________________________@*/
+bool Solver::takeGuidingPath(Cooperation* coop)
+{
+  for(; ind < coop->VecGuiding.size() && withinBudget(); ind = coop->nextGuidingPath()){
+    int    n   = pathStats.size();
+    double t0  = omp_get_wtime(), s0 = smallTime;
+    bool   enc = encodeGuidingPath(coop, ind);
+    double t1  = omp_get_wtime();
+    double t   = t1 - t0 - (smallTime - s0);
+    encodeTime += t;
+    if(pathStats.size() > n)
+      pathStats.last().encode = t;
+    if(enc){
+      max_learnts = (nClauses() + nVars()) * learntsize_factor;  // (no clauses in bitset mode)
+      pathStart = t1;
+      return true;
+    }
+  }
+  return false;
 }
 
 
+void Solver::openPath(int path, Var item, int nitems)
+{
+  pathStats.push();
+  PathStat& st = pathStats.last();
+  st.path     = path;
+  st.item     = itemName[item] + 1;
+  st.trans    = supportLeft;
+  st.rows     = pathRows.size();
+  st.items    = nitems;
+  st.clauses  = nClauses();
+  st.patterns = nbModels;
+  st.encode   = st.search = 0;
+  st.small    = false;
+}
+
 
-/*********************************************************************************
-//@ add_support_constraints : closure constraint
+void Solver::endPath(Cooperation* coop, bool finished)
+{
+  if (pathStart < 0) return;
+  PathStat& st = pathStats.last();
+  st.search   = omp_get_wtime() - pathStart;
+  st.patterns = nbModels - st.patterns;
+  pathStart   = -1;
+  if (finished)
+    coop->pathDone(this, st.path, st.patterns);
+}
 
-*********************************************************************************/
-void Solver::add_support_constraints(int num, vec<Lit>& lastTrans, vec<Lit>& items){
 
-  if(verbosity == 1){
-  vec<Lit> block_lits;
-  lastTrans.copyTo(block_lits);
-  block_lits.push(mkLit(num, true));
-  addClause(block_lits);
+/*_________________________________________________________________________________________________
+ |
+ |  foundItemset : (coop : Cooperation*) (util : int) (sup : int)  ->  [void]
+ |
+ |  Description:
+ |    Counts an itemset of utility 'util' and support 'sup' and hands it to the output, the top-k
+ |    itemsets or the callback of 'coop'. Its items are in 'outItems' if 'coop->wantItems()'.
+ |________________________________________________________________________________________________@*/
+void Solver::foundItemset(Cooperation* coop, int util, int sup)
+{
+  nbModels++;
+  if(coop->sweep.size() > 0){
+    int b = coop->sweep.size() - 1;
+    while(util < coop->sweep[b]) b--;
+    sweepHist[b]++;
   }
-  vec<Lit> liste;
+  if(coop->countOnly){
+    unsigned q = util / histBase;
+    utilHist[q > 1 ? 31 - __builtin_clz(q) : 0]++;
+  }else if(coop->topk > 0)
+    coop->addTopItemset(outItems, util, sup);
+  else if(coop->callback != NULL)
+    coop->callback(outItems.size() > 0 ? &outItems[0] : NULL, outItems.size(), util, sup, threadId, coop->callbackData);
+  else if(coop->out != NULL)
+    coop->out->write(threadId, outItems, util, sup);
+}
 
-  for(int i = 0; i < lastTrans.size(); i++) seen[var(lastTrans[i])] = 1;
 
-  if(verbosity == 1){
-    for(int i = 0; i < items.size(); i++) 
-      if(!seen[var(items[i])] && value(items[i]) != l_False)
-	liste.push(items[i]);
-    liste.push(mkLit(num, false));
-    addClause(liste);
+// The items merged into 'v' follow it, in input numbers: those of the database ('itemAlso'), then
+// those of the path and theirs.
+void Solver::outputItem(Cooperation* coop, Var v)
+{
+  for(; v != var_Undef; v = mergedNext[v]){
+    outItems.push(itemName[v]);
+    CsrRow<Var> also = coop->itemAlso[v];
+    for(int j = 0; j < also.size(); j++)
+      outItems.push(also[j]);
+  }
+}
+
+
+/*_________________________________________________________________________________________________
+ |
+ |  mineSmallPath : (coop : Cooperation*)  ->  [void]
+ |
+ |  Description:
+ |    Mines the guiding path assigned at level 0 by 'encodeGuidingPath()' without encoding it, for
+ |    paths of few distinct transactions ('pathRows', at most 64). A depth-first search extends the
+ |    itemset with the candidate items by increasing utility, keeping the rows of the itemset as a
+ |    bitmask and its utility in each row; a branch is cut when that utility plus the one of the later
+ |    candidates in these rows is below minutil, or when no row is new ('smallFresh'). In closed mode
+ |    only the closures are visited, each from the parent it extends by its first candidate
+ |    ('smallClosed()'). The itemsets are counted and output as the models of 'search()'.
+ |________________________________________________________________________________________________@*/
+void Solver::mineSmallPath(Cooperation* coop)
+{
+  double   t0  = omp_get_wtime();
+  int      R   = pathRows.size();
+  uint64_t all = R == 64 ? ~(uint64_t)0 : ((uint64_t)1 << R) - 1;
+  assert(R <= 64);
+
+  // the items of the rows with their rows, and the utility of each row over the items not false
+  vec<Var> found;
+  vec<int> rowWeight(R, 0);
+  smallMask.clear();
+  smallFresh = 0;
+  for(int r = 0; r < R; r++){
+    if(pathFresh[r])
+      smallFresh |= (uint64_t)1 << r;
+    CsrRow<Lit> row  = pathRows[r];
+    CsrRow<int> util = pathUtil[r];
+    for(int j = 0; j < row.size(); j++){
+      Var v = var(row[j]);
+      if(smallIndex[v] < 0){
+	smallIndex[v] = found.size();
+	found.push(v);
+	smallMask.push(0);
+      }
+      smallMask[smallIndex[v]] |= (uint64_t)1 << r;
+      if(value(v) != l_False)
+	rowWeight[r] += util[j];
+    }
   }
 
+  // candidates: the undecided items whose rows weigh minutil, by increasing weight; the true items
+  // follow, then the others, which only the closure looks at
+  vec<int> weight(found.size(), 0);
+  vec<int> cands, base, others;
+  for(int k = 0; k < found.size(); k++){
+    for(uint64_t b = smallMask[k]; b; b &= b - 1)
+      weight[k] += rowWeight[__builtin_ctzll(b)];
+    lbool x = value(found[k]);
+    if(x == l_True)                              base  .push(k);
+    else if(x == l_Undef && weight[k] >= min_supp) cands .push(k);
+    else                                         others.push(k);
+  }
+  sort(cands, ItemWeight_lt(weight));
+  smallCands = cands.size();
+  smallBase  = cands.size() + base.size();
+  for(int i = 0; i < base  .size(); i++) cands.push(base  [i]);
+  for(int i = 0; i < others.size(); i++) cands.push(others[i]);
+
+  smallItems.clear();
+  vec<uint64_t> mask;
+  for(int i = 0; i < cands.size(); i++){
+    smallItems.push(found[cands[i]]);
+    mask.push(smallMask[cands[i]]);
+    smallIndex[found[cands[i]]] = i;
+  }
+  mask.moveTo(smallMask);
+
+  smallUtil.clear();
+  smallUtil.growTo(smallBase * R, 0);
+  for(int r = 0; r < R; r++){
+    CsrRow<Lit> row  = pathRows[r];
+    CsrRow<int> util = pathUtil[r];
+    for(int j = 0; j < row.size(); j++){
+      int k = smallIndex[var(row[j])];
+      if(k < smallBase)
+	smallUtil[k * R + r] = util[j];
+    }
+  }
+  for(int i = 0; i < smallItems.size(); i++)
+    smallIndex[smallItems[i]] = -1;
+
+  smallRest.clear();
+  smallRest.growTo(smallCands * R, 0);
+  for(int k = smallCands - 2; k >= 0; k--)
+    for(int r = 0; r < R; r++)
+      smallRest[k * R + r] = smallRest[(k + 1) * R + r] + smallUtil[(k + 1) * R + r];
+
+  // the itemset of the path: its true items (and in closed mode the items of all its rows)
+  smallSum.clear();
+  smallSum.growTo((smallCands + 1) * R, 0);
+  smallSet.clear();
+  smallIn.clear();
+  smallIn.growTo(smallCands, 0);
+  bool closed = true;
+  if(coop->enum_clos == 1){
+    for(int k = smallBase; k < smallItems.size(); k++)
+      if(smallMask[k] == all)
+	closed = false;
+    for(int k = 0; k < smallCands; k++)
+      if(smallMask[k] == all)
+	smallIn[k] = 1, smallSet.push(k);
+  }
+
+  if(R > 0 && closed){
+    int64_t util = 0;
+    for(int r = 0; r < R; r++){
+      for(int k = smallCands; k < smallBase; k++)
+	smallSum[r] += smallUtil[k * R + r];
+      for(int i = 0; i < smallSet.size(); i++)
+	smallSum[r] += smallUtil[smallSet[i] * R + r];
+      util += smallSum[r];
+    }
+    if(util >= min_supp)
+      smallItemset(coop, util, all);
+    if(coop->enum_clos == 1) smallClosed(coop, 0, all, -1);
+    else                     smallAll   (coop, 0, all, -1);
+  }
+
+  double t = omp_get_wtime() - t0;
+  smallTime += t;
+  PathStat& st = pathStats.last();
+  st.clauses  = 0;
+  st.patterns = nbModels - st.patterns;
+  st.search   = t;
+  st.small    = true;
+  coop->pathDone(this, st.path, st.patterns);
+}
+
+
+// Closed itemsets extending the current one (rows 'rows', utilities at 'depth') with candidates
+// after 'core': the closure of each extension must not hold an earlier candidate, nor an item that
+// can't be in the itemset.
+void Solver::smallClosed(Cooperation* coop, int depth, uint64_t rows, int core)
+{
+  int        R   = pathRows.size();
+  int*       sum = &smallSum[depth * R];
+  int*       ext = &smallSum[(depth + 1) * R];
+  const int* U   = &smallUtil[0];
+  const int* Rs  = &smallRest[0];
+
+  for(int j = core + 1; j < smallCands; j++){
+    if(smallIn[j])
+      continue;
+    uint64_t t = rows & smallMask[j];
+    if((t & smallFresh) == 0)
+      continue;
+    if(coop->topk > 0)
+      min_supp = coop->threshold();
+
+    int64_t bound = 0;
+    for(uint64_t b = t; b; b &= b - 1){
+      int r = __builtin_ctzll(b);
+      bound += sum[r] + U[j * R + r] + Rs[j * R + r];
+    }
+    if(bound < min_supp)
+      continue;
+
+    bool keep = true;
+    for(int k = smallBase; keep && k < smallItems.size(); k++)
+      keep = (smallMask[k] & t) != t;
+    for(int k = 0; keep && k < j; k++)
+      keep = smallIn[k] || (smallMask[k] & t) != t;
+    if(!keep)
+      continue;
+
+    int n = smallSet.size();
+    for(int k = j; k < smallCands; k++)
+      if(!smallIn[k] && (smallMask[k] & t) == t)
+	smallIn[k] = 1, smallSet.push(k);
+
+    int64_t util = 0;
+    for(uint64_t b = t; b; b &= b - 1){
+      int r = __builtin_ctzll(b);
+      ext[r] = sum[r];
+      for(int i = n; i < smallSet.size(); i++)
+	ext[r] += U[smallSet[i] * R + r];
+      util += ext[r];
+    }
+    if(util >= min_supp)
+      smallItemset(coop, util, t);
+    smallClosed(coop, depth + 1, t, j);
+
+    for(int i = n; i < smallSet.size(); i++)
+      smallIn[smallSet[i]] = 0;
+    smallSet.shrink(smallSet.size() - n);
+  }
+}
+
+
+// All the itemsets extending the current one with candidates after 'core'.
+void Solver::smallAll(Cooperation* coop, int depth, uint64_t rows, int core)
+{
+  int        R   = pathRows.size();
+  int*       sum = &smallSum[depth * R];
+  int*       ext = &smallSum[(depth + 1) * R];
+  const int* U   = &smallUtil[0];
+  const int* Rs  = &smallRest[0];
+
+  for(int j = core + 1; j < smallCands; j++){
+    uint64_t t = rows & smallMask[j];
+    if((t & smallFresh) == 0)
+      continue;
+    if(coop->topk > 0)
+      min_supp = coop->threshold();
+
+    int64_t util = 0, rest = 0;
+    for(uint64_t b = t; b; b &= b - 1){
+      int r = __builtin_ctzll(b);
+      ext[r] = sum[r] + U[j * R + r];
+      util  += ext[r];
+      rest  += Rs[j * R + r];
+    }
+    if(util + rest < min_supp)
+      continue;
+
+    smallSet.push(j);
+    if(util >= min_supp)
+      smallItemset(coop, util, t);
+    if(rest > 0)
+      smallAll(coop, depth + 1, t, j);
+    smallSet.pop();
+  }
+}
+
+
+void Solver::smallItemset(Cooperation* coop, int64_t util, uint64_t rows)
+{
+  if(coop->wantItems()){
+    outItems.clear();
+    for(int k = smallCands; k < smallBase; k++)
+      outputItem(coop, smallItems[k]);
+    for(int i = 0; i < smallSet.size(); i++)
+      outputItem(coop, smallItems[smallSet[i]]);
+  }
+  int sup = 0;
+  for(uint64_t b = rows; b; b &= b - 1)
+    sup += pathCount[__builtin_ctzll(b)];
+  foundItemset(coop, util, sup);
+}
+
+
+/*********************************************************************************
+//@ add_support_constraints : support constraints, a transaction of the path is false as soon as
+//  an item outside of it is true (whatever the verbosity: the clauses of the other direction, true
+//  transaction when no outer item is, only slowed the propagation down)
+
+*********************************************************************************/
+void Solver::add_support_constraints(int num, CsrRow<Lit> lastTrans, vec<Lit>& items){
+
+  for(int i = 0; i < lastTrans.size(); i++) seen[var(lastTrans[i])] = 1;
+
   for(int i = 0; i < items.size(); i++){
-    vec<Lit> binClause;
     if(!seen[var(items[i])] && value(items[i]) != l_False)
       addClause(mkLit(num, true),~items[i]);
   }		   
@@ -1137,7 +2171,6 @@ void Solver::Equiv(Lit q, vec<Lit>& lits, Cooperation* coop){
 }
 
 //=================================================================================================
-$
 //chercher le maximum
 
 /**
@@ -1325,7 +2358,7 @@ void Solver::relocAll(ClauseAllocator& to)
     for (int i = 0; i < trail.size(); i++){
         Var v = var(trail[i]);
 		
-        if (reason(v) != CRef_Undef && (ca[reason(v)].reloced() || locked(ca[reason(v)])))
+        if (reason(v) < CRef_Lazy && (ca[reason(v)].reloced() || locked(ca[reason(v)])))
             ca.reloc(vardata[v].reason, to);
     }
 	
@@ -1355,54 +2388,3 @@ void Solver::garbageCollect()
                ca.size()*ClauseAllocator::Unit_Size, to.size()*ClauseAllocator::Unit_Size);
     to.moveTo(ca);
 }
-
-
-/*_________________________________________________________________________________________________                                                                                                                                                                                         
-                                                                                                                                                                                                                                                                                            
- uncheckedEnqueueImportedUnits : (Cooperation* coop)                                                                                                                                                                                                                                        
- Description :                                                                                                                                                                                                                                                                              
- At level 0, units literals propaged are exported to others threads                                                                                                                                                                                                                         
-*/
-
-void Solver::exportClause(Cooperation* coop, vec<Lit>& learnt_clause) {
-
-  if(coop->limitszClauses() < 1)
-    return;
-
-  if(decisionLevel() == 0){
-    for(int i = tailUnitLit; i < trail.size(); i++)
-      coop->exportExtraUnit(this, trail[i]) ;
-    tailUnitLit = trail.size();
-  }else
-    coop->exportExtraClause(this, learnt_clause);
-}
-
-
-//=================================================================================================                                                                                                                                                                                         
-// add Clauses received from others threads                                                                                                                                                                                                                                                 
-
-CRef Solver::addExtraClause(vec<Lit>& lits){
-  CRef cr = ca.alloc(lits, true);
-  learnts.push(cr);
-  attachClause(cr);
-  claBumpActivity(ca[cr]);
-  return cr;
-}
-
-//=================================================================================================                                                                                                                                                                                         
-// at level 0, unit extra clauses stored are propagated                                                                                                                                                                                                                                     
-
-void Solver::propagateExtraUnits(){
-  for(int i = 0; i < extraUnits.size(); i++)
-    if(value(extraUnits[i]) == l_Undef)
-      uncheckedEnqueue(extraUnits[i]);
-}
-
-
-
-
-
-
-
-
-
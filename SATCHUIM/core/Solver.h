@@ -24,6 +24,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "mtl/Vec.h"
 #include "mtl/Heap.h"
 #include "mtl/Alg.h"
+#include "mtl/Bitset.h"
+#include "mtl/Csr.h"
 #include "utils/Options.h"
 #include "core/SolverTypes.h"
 
@@ -32,6 +34,25 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 namespace Minisat {
 
+// Conflicts returned by 'propagate()' when the remaining utility drops below minutil, and when an
+// item assigned false belongs to the closure of the current itemset:
+const CRef CRef_Bound   = CRef_Undef - 1;
+const CRef CRef_Closure = CRef_Undef - 2;
+// Reason of the literals implied by the bound and by the tidsets (the closure ones are of reason
+// CRef_Closure), explained on demand by 'analyze()':
+const CRef CRef_Lazy    = CRef_Undef - 3;
+
+// Items by support, then hash of their transactions, then index: the items in the same transactions
+// end up next to each other (see 'Cooperation::pruneItems()' and 'Solver::mergePathItems()').
+struct ItemKey_lt {
+    const vec<int>&       sup;
+    const vec<uint32_t>&  hash;
+    bool operator () (Var x, Var y) const {
+        return sup[x] < sup[y] || (sup[x] == sup[y] && (hash[x] < hash[y] || (hash[x] == hash[y] && x < y))); }
+    bool same (Var x, Var y) const { return sup[x] == sup[y] && hash[x] == hash[y]; }
+    ItemKey_lt(const vec<int>& s, const vec<uint32_t>& h) : sup(s), hash(h) { }
+};
+
 //=================================================================================================
 // Solver -- the main class:
 
@@ -154,6 +175,7 @@ public:
     vec<Lit>  importedUnits;
     
     vec<int>            VecItems;
+    vec<Var>            itemName;         // original number of each item
     vec<int>            VecTrans;
 
     // Statistics: (read-only member variable)
@@ -163,16 +185,20 @@ public:
 
     int      curr_restarts;
 
-    CRef     addExtraClause(vec<Lit>& lits); 
     void     uncheckedEnqueue (Lit p, CRef from = CRef_Undef);                         // Enqueue a literal. Assumes value of literal is undefined.
-    int      tailUnitLit;
     int      diviser_state;
-    vec<Lit> extraUnits;
     void     cancelUntil      (int level);                                             // Backtrack until a certain level.
     void     analyze          (CRef confl, vec<Lit>& out_learnt, int& out_btlevel);    // (bt = backtrack)
     int      level            (Var x) const;
     int      decisionLevel    ()      const; // Gives the current decisionlevel.
     CRef     propagate        ();                                                      // Perform unit propagation. Returns possibly conflicting clause.
+    CRef     propagateUtility (bool scan);                                             // Propagate the minutil bound. Returns CRef_Bound on conflict.
+    CRef     propagateBitset  ();                                                      // Propagate support and closure on tidsets. Returns CRef_Closure on conflict.
+    CRef     propagateClosure ();                                                      // Propagate closure on counters. Returns CRef_Closure on conflict.
+    void     countUtility     (Var x);                                                 // Remove the pairs of a false item or transaction from the weights.
+    void     uncountUtility   (Var x);                                                 // Undo 'countUtility()' when backtracking.
+    void     uncountClosure   (Var x);                                                 // Undo the closure counting of a false transaction.
+    int      localUtility     (Var z, int limit);                                      // Upper bound on the utility of the current itemset extended with 'z'.
 	  
     vec<Lit>            assumptions;      // Current set of assumptions provided to solve by the user.
 
@@ -180,9 +206,28 @@ public:
     void  printModels();
     void  printClause(CRef cr);
     void  printClause(vec<Lit>& lits);
-    int   nbModels;
+    uint64_t nbModels;
+    double   encodeTime;                  // wall time spent switching to and encoding guiding paths ...
+    double   solveTime;                   // ... out of the wall time of the thread, see 'Cooperation::LaunchSolvers()'
+    double   smallTime;                   // ... of which mining the small paths, see 'mineSmallPath()' (not encoding)
+    struct PathStat {                     // a guiding path mined by the thread:
+      int      path, item;                // its index in 'Cooperation::VecGuiding' and item (as in the input)
+      int      trans, rows, items;        // projected transactions, distinct ones and candidate items
+      int      clauses;                   // clauses once encoded
+      uint64_t patterns;                  // itemsets found
+      double   encode, search;            // wall times
+      bool     small;                     // mined by 'mineSmallPath()', not encoded
+    };
+    vec<PathStat> pathStats;
+    double   pathStart;                   // start of the search of the current path (-1: none)
+    vec<uint64_t> utilHist;               // count-only mode: itemsets of utility in [histBase.2^b, histBase.2^(b+1))
+    int   histBase;
+    vec<uint64_t> sweepHist;              // sweep mode: itemsets of utility in [sweep[b], sweep[b+1]), see 'Cooperation::sweep'
     int   Freq;
     int   nbTrans; //Number of transactions.
+    Csr<Lit>* dbTrans;                    // database read by the thread: 'Cooperation::list_transactions' ...
+    Csr<int>* dbUtil;                     // ... 'wItemTrans' and 'appearTrans', or their copy on its NUMA node
+    Csr<int>* dbAppear;
     vec<Lit>            items;
     int      nbClauses;
     vec<Lit> allItems;
@@ -215,6 +260,36 @@ public:
         VarOrderLt(const vec<double>&  act) : activity(act) { }
     };
 
+    struct ItemWeight_gt {
+        const vec<int>&  weight;
+        bool operator () (Var x, Var y) const { return weight[x] > weight[y]; }
+        ItemWeight_gt(const vec<int>&  w) : weight(w) { }
+    };
+
+    struct ItemWeight_lt {                // increasing, ties by index
+        const vec<int>&  weight;
+        bool operator () (int x, int y) const { return weight[x] < weight[y] || (weight[x] == weight[y] && x < y); }
+        ItemWeight_lt(const vec<int>&  w) : weight(w) { }
+    };
+
+    // Orders the projected transactions so that identical ones are adjacent:
+    struct ProjRow_lt {
+        Csr<Lit>&             rows;
+        const vec<uint32_t>&  hash;
+        bool same (int x, int y) const {
+            CsrRow<Lit> a = rows[x], b = rows[y];
+            if (hash[x] != hash[y] || a.size() != b.size()) return false;
+            for (int i = 0; i < a.size(); i++) if (a[i] != b[i]) return false;
+            return true; }
+        bool operator () (int x, int y) const {
+            CsrRow<Lit> a = rows[x], b = rows[y];
+            if (hash[x] != hash[y])    return hash[x] < hash[y];
+            if (a.size() != b.size())  return a.size() < b.size();
+            for (int i = 0; i < a.size(); i++) if (a[i] != b[i]) return a[i] < b[i];
+            return x < y; }
+        ProjRow_lt(Csr<Lit>& r, const vec<uint32_t>& h) : rows(r), hash(h) { }
+    };
+
     // Solver state:
     //
     bool                ok;               // If FALSE, the constraints are already unsatisfiable. No part of the solver state may be used!
@@ -242,14 +317,56 @@ public:
     ClauseAllocator     ca;
 
     //Encodage
-    uint64_t            max_clauses;	
-    int                 init_vars;
-    vec<int>            hu_wei;
-    int                 totalWeight;
+    int                 totalWeight;      // utility of the (transaction,item) pairs with neither side counted false
+    vec<int>            itemWeight;       // utility of each item over the transactions not yet counted false
+    vec<int>            transWeight;      // utility of each transaction over the items not yet counted false
+    vec<char>           counted;          // false literal already applied to the weights by 'propagateUtility()'
+    Csr<Lit>            pathRows;         // items of each transaction variable 'nbItems + i' of the path ...
+    Csr<int>            pathUtil;         // ... and their utilities, summed over the transactions it merges
+    vec<int>            pathCount;        // number of transactions merged into each transaction variable ...
+    vec<char>           pathFresh;        // ... and whether one is new, see 'Cooperation::firstNew'
+    int                 supportLeft;      // transactions of the path not counted false
+    vec<int>            outItems;         // items of the itemset found, for the output
+    vec<Var>            mergedNext;       // next item merged into the same item on the path (var_Undef: none)
+    Csr<Lit>            projRows;         // transactions of the path projected on 'inProj' ...
+    Csr<int>            projUtil;         // ... their utilities ...
+    vec<uint32_t>       projHash;         // ... and a hash of their items
+    vec<char>           inProj;           // items kept in the transactions of the path
+    vec<Var>            boundItems;       // path items by decreasing utility at level 0 ...
+    vec<int>            boundCut;         // ... and that utility (an upper bound on 'itemWeight')
+    int                 bhead;            // Head of the utility bound queue (as index into the trail).
+    int                 scanWeight;       // 'totalWeight' at the last scan for items implied by the bound
+    bool                bitsetMode;       // support and closure checked on tidsets instead of clauses
+    enum { modeAll, modeClosed, modeBitset };
+    int                 searchMode;       // propagators of the run, fixed by 'EncodeDB()': clauses, clauses and
+                                          // closure counters, or tidsets (the loops are compiled for each)
+    int                 tidWords;         // words per tidset of the current path
+    vec<uint64_t>       tidsets;          // tidset of each path item over the transaction variables of the path
+    vec<int>            tidOffset;        // offset of each item tidset in 'tidsets' (-1 if not in the path)
+    vec<uint64_t>       cover;            // transaction variables of the path not assigned false
+    vec<uint64_t>       freshRows;        // those of 'pathFresh' if not all (empty otherwise)
+    vec<Var>            closItems;        // items checked for closure
+    vec<int>            outCount;         // transactions of the path not containing each item ...
+    vec<int>            falseCount;       // ... and those among the false ones containing it
+    int                 chead;            // Head of the closure counter queue (as index into the trail).
+    int                 closScan;         // 'nbFalseTrans' at the last closure scan (-1 after backtracking)
+    int                 xhead;            // Head of the tidset propagator queue (as index into the trail).
+    Var                 closConfl;        // item of the last CRef_Closure conflict (var_Undef: no new transaction left)
+    vec<Var>            smallItems;       // items of a small path: the candidates in search order, the true items
+    int                 smallCands;       // and the others, ending at 'smallCands', 'smallBase' and 'smallItems.size()' ...
+    int                 smallBase;
+    vec<uint64_t>       smallMask;        // ... the rows (of 'pathRows') holding each of them ...
+    vec<int>            smallUtil;        // ... the utility of the first 'smallBase' in each row ...
+    vec<int>            smallRest;        // ... and that of the candidates after each candidate in each row
+    uint64_t            smallFresh;       // rows of 'pathFresh'
+    vec<int>            smallIndex;       // position of each item in 'smallItems' (-1: none)
+    vec<int>            smallSum;         // utility of the current itemset in each row, per depth of the search
+    vec<int>            smallSet;         // candidates in the current itemset ...
+    vec<char>           smallIn;          // ... as flags
     int                 nbItems; //Number of items.
     vec<Lit>            transLits;
     vec<char>           isTrans;
-    int                 nbFalseTrans;
+    int                 nbFalseTrans;     // transactions of the path counted false by 'propagateClosure()'
     vec<CRef>           DBclauses;
     int                 ind;
    // vec<char>           seen;
@@ -257,7 +374,10 @@ public:
     vec<int>            seenItem;
     vec<int>            useless;
     vec<int>            SortedItem;
-    vec<vec<Lit> >      local_trans;
+    Csr<Lit>            local_trans;      // transaction variables of the path containing each item ...
+    Csr<int>            local_util;       // ... and the utility of the item in them
+    vec<vec<Lit> >      local_out;        // transactions of the path without each item, if fewer than with it
+    vec<char>           complement;       // 'local_out' is built for the item
     //Sauvgarder les items et les transactions
 
 
@@ -269,6 +389,8 @@ public:
     vec<int>            seen;
     vec<Lit>            analyze_stack;
     vec<Lit>            analyze_toclear;
+    vec<Lit>            analyze_reason;
+    vec<uint64_t>       analyze_need;
     vec<Lit>            add_tmp;
 
     double              max_learnts;
@@ -280,21 +402,26 @@ public:
     int64_t             conflict_budget;    // -1 means no budget.
     int64_t             propagation_budget; // -1 means no budget.
     bool                asynch_interrupt;
+    char                pad[64];            // keeps the fields of two solvers of 'Cooperation::solvers' on separate lines
 
     // Main internal methods:
     //
 
     void     simplifier();
-    bool     encodeGuidingPath        (Cooperation*, int index);
-    void     add_closure_constraints  (Lit item, vec<Lit>& trans, vec<Lit>& app);
-    void     add_support_constraints  (int num, vec<Lit>& lastTrans, vec<Lit>& items);
-    void     add_closure_constraints  (vec<Lit>& trans, vec<Lit>& app);
+    bool     encodeGuidingPath        (Cooperation*, int path);
+    bool     takeGuidingPath          (Cooperation* coop);  // encodes the path 'ind' or a later one, false if none is left
+    void     openPath                 (int path, Var item, int nitems);  // opens the record of a path in 'pathStats' ...
+    void     endPath                  (Cooperation* coop, bool finished);  // ... and closes that of the current path
+    void     mineSmallPath            (Cooperation* coop);
+    void     smallClosed              (Cooperation* coop, int depth, uint64_t rows, int core);
+    void     smallAll                 (Cooperation* coop, int depth, uint64_t rows, int core);
+    void     smallItemset             (Cooperation* coop, int64_t util, uint64_t rows);
+    void     foundItemset             (Cooperation* coop, int util, int sup);  // an itemset to count and output ('outItems')
+    void     outputItem               (Cooperation* coop, Var v);  // pushes 'v' and the items merged into it to 'outItems'
+    void     mergePathItems           ();
+    void     add_support_constraints  (int num, CsrRow<Lit> lastTrans, vec<Lit>& items);
 
     void     cancelAll        ();
-    void     propagateExtraUnits();
-    lbool    importClauses    (Cooperation* coop); 
-    void     exportClause     (Cooperation* coop, vec<Lit>& learnt_clause);
-    int      updateFrequency  (Cooperation* coop);
 
     void     insertVarOrder   (Var x);                                                 // Insert a variable in the decision order priority queue.
     Lit      pickBranchLit    ();                                                      // Return the next decision variable.
@@ -303,9 +430,17 @@ public:
     bool     enqueue          (Lit p, CRef from = CRef_Undef);                         // Test if fact 'p' contradicts current state, enqueue otherwise.
     void     analyzeFinal     (Lit p, vec<Lit>& out_conflict);                         // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
     bool     litRedundant     (Lit p, uint32_t abstract_levels);                       // (helper method for 'analyze()')
+    void     explain          (Lit p, CRef from, int end, int& lazy, vec<Lit>& out);  // (helper method for 'analyze()')
     lbool    search           (int nof_conflicts, Cooperation* coop);                                     // Search for a given number of conflicts.
-
-    void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
+    template<int M> lbool search_      (int nof_conflicts, Cooperation* coop);   // 'search()', 'propagate()' and 'cancelUntil()' in mode 'M'
+    template<int M> CRef  propagate_   ();
+    template<int M> void  cancelUntil_ (int level);
+    template<int M> bool  backjump_    (vec<Lit>& learnt, int btlevel);  // undo the conflict analyzed into 'learnt'
+    template<int M> bool  refute_      ();  // refute the last decision not refuted yet, false if none is left
+    int      lastRefuted      ()      const;                                           // Last level whose decision is a refutation (0: none).
+
+    void     reduceDB         ();                                                      // Release all the clauses of the finished guiding path.
+    void     reduceLearnts    ();                                                      // Remove half of the learnt clauses of the path.
     void     removeSatisfied  (vec<CRef>& cs);                                         // Shrink 'cs' to contain only non-satisfied clauses.
     void     rebuildOrderHeap ();
 
@@ -393,7 +528,7 @@ inline bool     Solver::addEmptyClause  ()                      { add_tmp.clear(
 inline bool     Solver::addClause       (Lit p)                 { add_tmp.clear(); add_tmp.push(p); return addClause_(add_tmp); }
 inline bool     Solver::addClause       (Lit p, Lit q)          { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); return addClause_(add_tmp); }
 inline bool     Solver::addClause       (Lit p, Lit q, Lit r)   { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); return addClause_(add_tmp); }
-inline bool     Solver::locked          (const Clause& c) const { return value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && ca.lea(reason(var(c[0]))) == &c; }
+inline bool     Solver::locked          (const Clause& c) const { return value(c[0]) == l_True && reason(var(c[0])) < CRef_Lazy && ca.lea(reason(var(c[0]))) == &c; }
 inline void     Solver::newDecisionLevel()                      { trail_lim.push(trail.size()); }
 
 inline int      Solver::decisionLevel ()      const   { return trail_lim.size(); }
@@ -0,0 +1,61 @@
+#!/bin/sh
+##
+##  Benchmark of SATCHUIM over the bundled datasets: "make bench" in core, or
+##
+##      sh bench.sh <solver> [datasets-dir]
+##
+##  Each dataset is mined at a fixed grid of minutils, closed and not, with each thread count of
+##  THREADS, REPEAT times. One CSV line per setting goes to the standard output, each field the
+##  median of its runs. Times are in seconds: 'encode' and 'search' are summed over the threads,
+##  'prep' is the pruning and the guiding paths. Progress and failures go to the standard error.
+##
+##      REPEAT=5 THREADS="1 2 4 8" make bench > bench.csv
+
+SOLVER=${1:-./SATCHUIM}
+DATASETS=${2:-../../datasets}
+REPEAT=${REPEAT:-3}
+THREADS=${THREADS:-"1 4"}
+
+# dataset and its minutils
+GRID="chess:600000,500000 connect:16000000,15000000 mushroom:200000,100000 foodmart:3000,2000"
+
+FIELDS="wall parse prep encode search patterns propagations conflicts rss_mb"
+
+echo "dataset,minutil,closed,threads,runs,$(echo $FIELDS | tr ' ' ',')"
+
+for entry in $GRID; do
+  name=${entry%%:*}
+  file=$DATASETS/$name.txt
+  if [ ! -r "$file" ]; then echo "bench: no $file, skipped" >&2; continue; fi
+  for minutil in $(echo ${entry#*:} | tr ',' ' '); do
+    for closed in 0 1; do
+      for threads in $THREADS; do
+        echo "bench: $name minutil=$minutil closed=$closed threads=$threads" >&2
+        runs=""
+        i=0
+        while [ $i -lt $REPEAT ]; do
+          line=$("$SOLVER" -stats -minutil=$minutil -closed=$closed -ncores=$threads "$file" | grep '^STATS complete=1 ')
+          if [ -z "$line" ]; then echo "bench: run failed" >&2; break; fi
+          runs="$runs$line
+"
+          i=$((i+1))
+        done
+        [ -z "$runs" ] && continue
+        printf "%s" "$runs" | awk -v head="$name,$minutil,$closed,$threads" -v fields="$FIELDS" '
+          { for (i = 2; i <= NF; i++){ split($i, kv, "="); v[kv[1], NR] = kv[2] } }
+          END {
+            n = split(fields, f, " ")
+            out = head "," NR
+            for (k = 1; k <= n; k++){
+              for (r = 1; r <= NR; r++) a[r] = v[f[k], r] + 0
+              for (r = 2; r <= NR; r++)          # insertion sort, a few runs
+                for (s = r; s > 1 && a[s-1] > a[s]; s--){ t = a[s]; a[s] = a[s-1]; a[s-1] = t }
+              m = (NR % 2) ? a[(NR+1)/2] : (a[NR/2] + a[NR/2+1]) / 2
+              out = out "," m
+            }
+            print out
+          }'
+      done
+    done
+  done
+done
@@ -36,6 +36,8 @@ class RegionAllocator
     uint32_t  sz;
     uint32_t  cap;
     uint32_t  wasted_;
+    uint32_t  region_sz;
+    uint32_t  region_wasted;
 
     void capacity(uint32_t min_cap);
 
@@ -45,7 +47,7 @@ class RegionAllocator
     enum { Ref_Undef = UINT32_MAX };
     enum { Unit_Size = sizeof(uint32_t) };
 
-    explicit RegionAllocator(uint32_t start_cap = 1024*1024) : memory(NULL), sz(0), cap(0), wasted_(0){ capacity(start_cap); }
+    explicit RegionAllocator(uint32_t start_cap = 1024*1024) : memory(NULL), sz(0), cap(0), wasted_(0), region_sz(0), region_wasted(0){ capacity(start_cap); }
     ~RegionAllocator()
     {
         if (memory != NULL)
@@ -59,6 +61,11 @@ class RegionAllocator
     Ref      alloc     (int size); 
     void     free      (int size)    { wasted_ += size; }
 
+    // Scoped region: everything allocated after 'pushRegion()' is released at once by 'popRegion()'.
+    // NOTE: the mark is an offset, so it does not survive a relocation through 'moveTo()'.
+    void     pushRegion()            { region_sz = sz; region_wasted = wasted_; }
+    void     popRegion ()            { assert(region_sz <= sz); sz = region_sz; wasted_ = region_wasted; }
+
     // Deref, Load Effective Address (LEA), Inverse of LEA (AEL):
     T&       operator[](Ref r)       { assert(r >= 0 && r < sz); return memory[r]; }
     const T& operator[](Ref r) const { assert(r >= 0 && r < sz); return memory[r]; }
@@ -74,9 +81,10 @@ class RegionAllocator
         to.sz = sz;
         to.cap = cap;
         to.wasted_ = wasted_;
+        to.region_sz = to.region_wasted = 0;
 
         memory = NULL;
-        sz = cap = wasted_ = 0;
+        sz = cap = wasted_ = region_sz = region_wasted = 0;
     }
 
 
@@ -0,0 +1,49 @@
+#ifndef Minisat_Bitset_h
+#define Minisat_Bitset_h
+
+#include "mtl/IntTypes.h"
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace Minisat {
+
+//=================================================================================================
+// Kernels over dense bitsets stored as arrays of 64-bit words. The vector versions are selected
+// at compile time (e.g. COPTIMIZE="-O3 -march=native"); the arrays need no particular alignment.
+
+static inline int  bitWords (int n)                    { return (n + 63) >> 6; }
+static inline void bitSet   (uint64_t* a, int i)       { a[i >> 6] |=   (uint64_t)1 << (i & 63);  }
+static inline void bitClear (uint64_t* a, int i)       { a[i >> 6] &= ~((uint64_t)1 << (i & 63)); }
+static inline bool bitTest  (const uint64_t* a, int i) { return (a[i >> 6] >> (i & 63)) & 1; }
+
+
+// Is 'a' included in 'b' ('a & ~b' empty)?
+static inline bool bitSubset(const uint64_t* a, const uint64_t* b, int n)
+{
+    int i = 0;
+#if defined(__AVX512F__)
+    for (; i + 8 <= n; i += 8){
+        __m512i x = _mm512_andnot_si512(_mm512_loadu_si512((const void*)(b + i)),
+                                        _mm512_loadu_si512((const void*)(a + i)));
+        if (_mm512_test_epi64_mask(x, x))
+            return false; }
+#elif defined(__AVX2__)
+    for (; i + 4 <= n; i += 4){
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+        if (!_mm256_testc_si256(y, x))
+            return false; }
+#endif
+    for (; i < n; i++)
+        if (a[i] & ~b[i])
+            return false;
+    return true;
+}
+
+
+//=================================================================================================
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef Minisat_Csr_h
+#define Minisat_Csr_h
+
+#include <string.h>
+
+#include "mtl/Vec.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// A row of a 'Csr', valid until the table is modified:
+
+template<class T>
+class CsrRow {
+    T*  data;
+    int sz;
+public:
+    CsrRow(T* d, int n) : data(d), sz(n) {}
+
+    int      size        (void)      const { return sz; }
+    T&       operator [] (int index) const { return data[index]; }
+    operator T*          (void)      const { return data; }
+};
+
+
+//=================================================================================================
+// Table of rows stored contiguously (compressed sparse rows): row 'i' is 'data[beg[i] .. beg[i+1])'.
+//
+// Built either row by row ('push()' then 'push(x)' for each element), or in two passes when the
+// rows are filled out of order: 'shape(n)', 'grow(i)' for each element of row 'i', 'alloc()', then
+// 'fill(i, x)' again for each element.
+
+template<class T>
+class Csr {
+    vec<int> beg;
+    vec<T>   data;
+
+    // Don't allow copying (error prone):
+    Csr<T>&  operator = (Csr<T>& other) { assert(0); return *this; }
+             Csr        (Csr<T>& other) { assert(0); }
+
+public:
+    Csr() { beg.push(0); }
+
+    int       size        (void)  const { return beg.size() - 1; }
+    int       elems       (void)  const { return data.size(); }
+    int       size        (int i) const { return beg[i+1] - beg[i]; }
+    CsrRow<T> operator [] (int i)       { return CsrRow<T>((T*)data + beg[i], beg[i+1] - beg[i]); }
+
+    void      capacity    (int rows, int nelems) { beg.capacity(rows + 1); data.capacity(nelems); }
+    void      clear       (bool dealloc = false) { beg.clear(dealloc); data.clear(dealloc); beg.push(0); }
+    void      moveTo      (Csr<T>& dest)         { beg.moveTo(dest.beg); data.moveTo(dest.data); beg.push(0); }
+    void      copyTo      (Csr<T>& dest) const   { beg.copyTo(dest.beg); data.copyTo(dest.data); }
+
+    // Row by row:
+    void      push        (void)                 { int end = beg.last(); beg.push(end); }
+    void      push        (const T& elem)        { data.push(elem); beg.last()++; }
+    void      append      (const Csr<T>& other)  {
+        int off = data.size();
+        data.growTo(off + other.data.size());
+        if (other.data.size() > 0) memcpy((T*)data + off, &other.data[0], sizeof(T) * other.data.size());
+        for (int i = 1; i < other.beg.size(); i++) beg.push(off + other.beg[i]); }
+
+    // In two passes ('beg[i+1]' counts, then runs over, row 'i'):
+    void      shape       (int n)                { beg.clear(); beg.growTo(n + 1, 0); data.clear(); }
+    void      grow        (int i)                { beg[i+1]++; }
+    void      alloc       (void)                 {
+        int s = 0;
+        for (int i = 1; i < beg.size(); i++){ int n = beg[i]; beg[i] = s; s += n; }
+        data.growTo(s); }
+    void      fill        (int i, const T& elem) { data[beg[i+1]++] = elem; }
+};
+
+
+//=================================================================================================
+}
+
+#endif
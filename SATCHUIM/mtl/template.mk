@@ -61,10 +61,10 @@ $(EXEC)_debug:		$(DCOBJS)
 $(EXEC)_release:	$(RCOBJS)
 $(EXEC)_static:		$(RCOBJS)
 
-lib$(LIB)_standard.a:	$(filter-out */Main.o,  $(COBJS))
-lib$(LIB)_profile.a:	$(filter-out */Main.op, $(PCOBJS))
-lib$(LIB)_debug.a:	$(filter-out */Main.od, $(DCOBJS))
-lib$(LIB)_release.a:	$(filter-out */Main.or, $(RCOBJS))
+lib$(LIB)_standard.a:	$(filter-out %/Main.o,  $(COBJS))
+lib$(LIB)_profile.a:	$(filter-out %/Main.op, $(PCOBJS))
+lib$(LIB)_debug.a:	$(filter-out %/Main.od, $(DCOBJS))
+lib$(LIB)_release.a:	$(filter-out %/Main.or, $(RCOBJS))
 
 
 ## Build rule
@@ -90,7 +90,8 @@ libs libp libd libr:
 ## Clean rule
 clean:
 	@rm -f $(EXEC) $(EXEC)_profile $(EXEC)_debug $(EXEC)_release $(EXEC)_static \
-	  $(COBJS) $(PCOBJS) $(DCOBJS) $(RCOBJS) *.core depend.mk 
+	  $(COBJS) $(PCOBJS) $(DCOBJS) $(RCOBJS) *.core depend.mk \
+	  lib$(LIB).a lib$(LIB)_standard.a lib$(LIB)_profile.a lib$(LIB)_debug.a lib$(LIB)_release.a
 
 ## Make dependencies
 depend.mk: $(CSRCS) $(CHDRS)
@@ -71,6 +71,13 @@ static void skipWhitespace(B& in) {
         ++in; }
 
 
+// Skips the blanks of the current line (not its end):
+template<class B>
+static void skipBlanks(B& in) {
+    while (*in == 9 || *in == 13 || *in == 32)
+        ++in; }
+
+
 template<class B>
 static void skipLine(B& in) {
     for (;;){
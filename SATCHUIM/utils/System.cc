@@ -22,14 +22,13 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #if defined(__linux__)
 
+#include <dirent.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 using namespace Minisat;
 
-// TODO: split the memory reading functions into two: one for reading high-watermark of RSS, and
-// one for reading the current virtual memory size.
-
 static inline int memReadStat(int field)
 {
     char  name[256];
@@ -57,9 +56,10 @@ static inline int memReadPeak(void)
     FILE* in = fopen(name, "rb");
     if (in == NULL) return 0;
 
-    // Find the correct line, beginning with "VmPeak:":
+    // Find the correct line, beginning with "VmHWM:" (the peak resident set; "VmPeak:" is that of
+    // the address space, mostly thread stacks):
     int peak_kb = 0;
-    while (!feof(in) && fscanf(in, "VmPeak: %d kB", &peak_kb) != 1)
+    while (!feof(in) && fscanf(in, "VmHWM: %d kB", &peak_kb) != 1)
         while (!feof(in) && fgetc(in) != '\n')
             ;
     fclose(in);
@@ -69,9 +69,56 @@ static inline int memReadPeak(void)
 
 double Minisat::memUsed() { return (double)memReadStat(0) * (double)getpagesize() / (1024*1024); }
 double Minisat::memUsedPeak() { 
-    double peak = memReadPeak() / 1024;
+    double peak = memReadPeak() / 1024.0;
     return peak == 0 ? memUsed() : peak; }
 
+
+// The node of a CPU is told by the 'nodeN' entry of its directory in "/sys" (0 without one).
+static int cpuReadNode(int cpu)
+{
+    char name[256];
+    sprintf(name, "/sys/devices/system/cpu/cpu%d", cpu);
+    DIR* dir = opendir(name);
+    if (dir == NULL) return 0;
+    int node = 0;
+    for (struct dirent* e; (e = readdir(dir)) != NULL; )
+        if (sscanf(e->d_name, "node%d", &node) == 1) break;
+    closedir(dir);
+    return node;
+}
+
+struct CpuList {
+    int n;
+    int cpu [CPU_SETSIZE];
+    int node[CPU_SETSIZE];
+
+    CpuList() : n(0) {
+        cpu_set_t set;
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+            for (int c = 0; c < CPU_SETSIZE; c++)
+                if (CPU_ISSET(c, &set)){
+                    // insertion by node, then number
+                    int i = n++, x = cpuReadNode(c);
+                    for (; i > 0 && node[i-1] > x; i--)
+                        cpu[i] = cpu[i-1], node[i] = node[i-1];
+                    cpu[i] = c, node[i] = x; }
+        if (n == 0)
+            cpu[0] = -1, node[0] = 0, n = 1;
+    }
+};
+
+static const CpuList& cpuList() { static CpuList list; return list; }
+
+int  Minisat::cpuCount()       { return cpuList().n; }
+int  Minisat::cpuNode(int k)   { const CpuList& l = cpuList(); return l.node[k % l.n]; }
+bool Minisat::pinThread(int k) {
+    const CpuList& l = cpuList();
+    if (l.cpu[k % l.n] < 0) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(l.cpu[k % l.n], &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0; }
+
 #elif defined(__FreeBSD__)
 
 double Minisat::memUsed(void) {
@@ -93,3 +140,9 @@ double Minisat::memUsed(void) {
 double Minisat::memUsed() { 
     return 0; }
 #endif
+
+#if !defined(__linux__)
+int  Minisat::cpuCount()       { return 1; }
+int  Minisat::cpuNode(int k)   { return 0; }
+bool Minisat::pinThread(int k) { return false; }
+#endif
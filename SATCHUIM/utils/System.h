@@ -33,7 +33,12 @@ namespace Minisat {
 
 static inline double cpuTime(void); // CPU-time in seconds.
 extern double memUsed();            // Memory in mega bytes (returns 0 for unsupported architectures).
-extern double memUsedPeak();        // Peak-memory in mega bytes (returns 0 for unsupported architectures).
+extern double memUsedPeak();        // Peak resident memory in mega bytes (returns 0 for unsupported architectures).
+
+// The CPUs the process may run on, ordered by NUMA node (call once before binding any thread):
+extern int  cpuCount();              // Their number (1 for unsupported architectures).
+extern int  cpuNode(int k);          // NUMA node of the k-th of them, modulo their number (0 for unsupported architectures).
+extern bool pinThread(int k);        // Binds the calling thread to the k-th of them, modulo their number (false if unsupported).
 
 }
 